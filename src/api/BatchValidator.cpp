@@ -0,0 +1,110 @@
+#include <chrono>
+#include <stdexcept>
+
+#include "BatchValidator.h"
+#include "crossbar/ConstraintChecker.h"
+#include "parser/CQASMParser.h"
+#include "parser/TopologyLoader.h"
+
+BatchValidator::BatchValidator(const nlohmann::json& topology, int num_threads) : pool(num_threads) {
+	this->model = TopologyLoader::load(topology);
+	
+	// Use "max + 1" qubits to avoid an error in the parser
+	this->num_qubits = 1;
+	for (std::pair<int, Qubit*> element : this->model->iter_qubits_positions()) {
+		this->num_qubits = std::max(element.first + 1, this->num_qubits);
+	}
+}
+
+BatchValidator::BatchValidator(CrossbarModel* model, int num_threads) : pool(num_threads) {
+	this->model = model->clone();
+	
+	this->num_qubits = 1;
+	for (std::pair<int, Qubit*> element : this->model->iter_qubits_positions()) {
+		this->num_qubits = std::max(element.first + 1, this->num_qubits);
+	}
+}
+
+BatchValidator::~BatchValidator() {
+	delete this->model;
+}
+
+void BatchValidator::set_backend(const std::string& name) {
+	this->model->set_constraint_backend(name);
+}
+
+/**
+ * Durations used by the next batches (e.g. to sweep them)
+ * @param timing
+ * @throws std::runtime_error if an operation is too short for its steps
+ */
+void BatchValidator::set_timing(const TimingTable& timing) {
+	this->model->set_timing(timing);
+}
+
+int BatchValidator::get_num_threads() const {
+	return this->pool.get_num_threads();
+}
+
+/**
+ * Validate every program on its own copy of the crossbar. The parser is
+ * not reentrant, so programs are parsed in this thread and only the
+ * validation runs on the pool.
+ * @param programs cQASM texts
+ * @param names used in the results (index if empty)
+ * @return result of each program, in the same order
+ */
+std::vector<ProgramResult> BatchValidator::validate(const std::vector<std::string>& programs,
+		const std::vector<std::string>& names) {
+	std::vector<ProgramResult> results(programs.size());
+	std::vector<std::vector<std::vector<Operation*> > > operations(programs.size());
+	
+	for (size_t k = 0; k < programs.size(); k++) {
+		ProgramResult& result = results[k];
+		result.name = (k < names.size()) ? names[k] : std::to_string(k);
+		result.valid = true;
+		result.validate_ms = 0;
+		
+		auto start = std::chrono::steady_clock::now();
+		try {
+			operations[k] = CQASMParser::parse(CQASMParser::set_num_qubits(programs[k], this->num_qubits));
+		} catch (const std::exception& ex) {
+			result.valid = false;
+			result.message = ex.what();
+		}
+		auto end = std::chrono::steady_clock::now();
+		result.parse_ms = std::chrono::duration<double, std::milli>(end - start).count();
+		
+		if (!result.valid) continue;
+		
+		// Each task writes only its own result
+		CrossbarModel* base_model = this->model;
+		std::vector<std::vector<Operation*> >* program = &operations[k];
+		this->pool.submit([base_model, program, &result](int worker) {
+			auto start = std::chrono::steady_clock::now();
+			CrossbarModel* cloned_model = base_model->clone();
+			try {
+				ConstraintChecker::validate(cloned_model, *program);
+			} catch (const std::exception& ex) {
+				result.valid = false;
+				result.message = ex.what();
+			}
+			delete cloned_model;
+			auto end = std::chrono::steady_clock::now();
+			result.validate_ms = std::chrono::duration<double, std::milli>(end - start).count();
+		});
+	}
+	
+	this->pool.wait();
+	
+	// Free mem
+	for (std::vector<std::vector<Operation*> >& program : operations) {
+		for (std::vector<Operation*>& p_operations : program) {
+			for (Operation* operation : p_operations) {
+				delete operation;
+			}
+		}
+	}
+	
+	return results;
+}
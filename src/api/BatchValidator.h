@@ -0,0 +1,45 @@
+#ifndef CROSSBAR_SIMULATOR_BATCHVALIDATOR_H
+#define CROSSBAR_SIMULATOR_BATCHVALIDATOR_H
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "crossbar/CrossbarModel.h"
+#include "WorkStealingPool.h"
+
+/**
+ * Result and timings of one program of a batch
+ */
+struct ProgramResult {
+	std::string name;
+	bool valid;
+	std::string message;
+	double parse_ms;
+	double validate_ms;
+};
+
+/**
+ * Validates many programs against the same topology in parallel
+ */
+class BatchValidator {
+public:
+	BatchValidator(const nlohmann::json& topology, int num_threads = 0);
+	BatchValidator(CrossbarModel* model, int num_threads = 0);
+	
+	~BatchValidator();
+	
+	void set_backend(const std::string& name);
+	void set_timing(const TimingTable& timing);
+	int get_num_threads() const;
+	
+	std::vector<ProgramResult> validate(const std::vector<std::string>& programs,
+		const std::vector<std::string>& names = {});
+	
+private:
+	CrossbarModel* model;
+	WorkStealingPool pool;
+	int num_qubits;
+};
+
+#endif /* CROSSBAR_SIMULATOR_BATCHVALIDATOR_H */
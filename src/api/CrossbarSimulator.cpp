@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "CrossbarSimulator.h"
+#include "crossbar/ConstraintChecker.h"
+#include "parser/CQASMParser.h"
+#include "parser/TopologyLoader.h"
+
+CrossbarSimulator::CrossbarSimulator(int m, int n, int data_qubits, int ancilla_qubits) {
+	this->initial_model = new CrossbarModel(m, n, data_qubits, ancilla_qubits);
+	this->model = NULL;
+	this->num_cycles = 0;
+	this->reset();
+}
+
+CrossbarSimulator::CrossbarSimulator(const nlohmann::json& topology) {
+	this->initial_model = TopologyLoader::load(topology);
+	this->model = NULL;
+	this->num_cycles = 0;
+	this->reset();
+}
+
+CrossbarSimulator::~CrossbarSimulator() {
+	this->release_program();
+	delete this->model;
+	delete this->initial_model;
+}
+
+CrossbarSimulator* CrossbarSimulator::from_topology_file(const std::string& path) {
+	return new CrossbarSimulator(TopologyLoader::read_file(path));
+}
+
+/**
+ * Select the constraint solver ("naxos", "difference" or "auto")
+ */
+void CrossbarSimulator::set_backend(const std::string& name) {
+	this->initial_model->set_constraint_backend(name);
+	this->model->set_constraint_backend(name);
+}
+
+/**
+ * Simulate the quantum state of the qubits besides checking the
+ * constraints. Rewinds the crossbar.
+ * @param enabled
+ * @param num_threads threads of the statevector kernels (0: one per core)
+ * @param backend "statevector" (shared 2^n register, any gate) or
+ * "stabilizer" (hundreds of qubits, Clifford gates only)
+ * @throws std::runtime_error if the backend can not hold the qubits
+ */
+void CrossbarSimulator::set_simulation(bool enabled, int num_threads, const std::string& backend) {
+	if (enabled) {
+		this->initial_model->start_simulation(num_threads, backend);
+	} else {
+		this->initial_model->stop_simulation();
+	}
+	this->reset();
+}
+
+/**
+ * Seed the outcomes of the measurements. Rewinds the crossbar.
+ * @param seed
+ */
+void CrossbarSimulator::set_seed(uint64_t seed) {
+	this->initial_model->set_seed(seed);
+	this->reset();
+}
+
+/**
+ * Change the durations of the operations (e.g. to sweep them without
+ * reloading the topology). Rewinds the crossbar.
+ * @param timing
+ * @throws std::runtime_error if an operation is too short for its steps
+ */
+void CrossbarSimulator::set_timing(const TimingTable& timing) {
+	this->initial_model->set_timing(timing);
+	this->timeline = Timeline(this->operations, timing);
+	this->num_cycles = this->timeline.get_num_cycles();
+	this->reset();
+}
+
+/**
+ * Parse a cQASM program and rewind the crossbar to its initial state
+ * @param text
+ */
+void CrossbarSimulator::load_program(const std::string& text) {
+	// Use "max + 1" qubits to avoid an error in the parser
+	int num_qubits = 1;
+	for (std::pair<int, Qubit*> element : this->initial_model->iter_qubits_positions()) {
+		num_qubits = std::max(element.first + 1, num_qubits);
+	}
+	
+	std::vector<std::vector<Operation*> > operations = CQASMParser::parse(
+		CQASMParser::set_num_qubits(text, num_qubits)
+	);
+	
+	this->release_program();
+	this->operations = operations;
+	this->timeline = Timeline(this->operations, this->initial_model->get_timing());
+	this->num_cycles = this->timeline.get_num_cycles();
+	this->reset();
+}
+
+/**
+ * Reorder the loaded program into its as soon as possible schedule and
+ * rewind the crossbar
+ * @return cycles before and after
+ * @throws std::runtime_error if the program can not be scheduled
+ */
+ScheduleResult CrossbarSimulator::schedule() {
+	ScheduleResult result = Scheduler::schedule(this->initial_model, this->operations);
+	this->timeline = Timeline(this->operations, this->initial_model->get_timing());
+	this->num_cycles = this->timeline.get_num_cycles();
+	this->reset();
+	
+	return result;
+}
+
+/**
+ * Check the constraints of the loaded program on a copy of the initial crossbar
+ * @param report where the result of each cycle is written (optional)
+ */
+ValidationResult CrossbarSimulator::validate(std::ostream* report) {
+	CrossbarModel* cloned_model = this->initial_model->clone();
+	ValidationResult result = {true, ""};
+	try {
+		ConstraintChecker::validate(cloned_model, this->operations, report);
+		result.measurements = cloned_model->get_measurements();
+		result.errors = cloned_model->get_errors();
+	} catch (const std::exception& ex) {
+		result.valid = false;
+		result.message = ex.what();
+	}
+	delete cloned_model;
+	
+	return result;
+}
+
+/**
+ * Run the program once up to its measurements and draw the shots from the
+ * final state. The measured qubits must not be used afterwards. With
+ * noise, the errors of all the shots are propagated in the same run.
+ * @param shots
+ * @param seed
+ * @param num_threads threads that draw the shots (0: one per core)
+ * @throws std::runtime_error if the simulation is not enabled
+ */
+SampleResult CrossbarSimulator::sample(int shots, uint64_t seed, int num_threads) {
+	if (!this->initial_model->is_simulating()) {
+		throw std::runtime_error("Sampling needs the quantum state simulation");
+	}
+	
+	CrossbarModel* cloned_model = this->initial_model->clone();
+	cloned_model->set_sampling(true, shots);
+	SampleResult result = {true, ""};
+	try {
+		ConstraintChecker::validate(cloned_model, this->operations, NULL);
+		result.qubits = cloned_model->get_sampled_qubits();
+		result.counts = cloned_model->sample(shots, seed, num_threads);
+	} catch (const std::exception& ex) {
+		result.valid = false;
+		result.message = ex.what();
+	}
+	delete cloned_model;
+	
+	return result;
+}
+
+/**
+ * Execute the next cycle of the program
+ * @return false if the program has already finished
+ */
+bool CrossbarSimulator::step() {
+	if (this->curr_cycle >= this->num_cycles) {
+		return false;
+	}
+	
+	// Replay the cycle if it was already executed
+	if (!this->model->step_forward()) {
+		ConstraintChecker::step(this->model, this->timeline, this->curr_cycle);
+	}
+	this->curr_cycle++;
+	
+	return true;
+}
+
+/**
+ * Undo the last executed cycle
+ * @return false if the program is at its first cycle
+ */
+bool CrossbarSimulator::step_back() {
+	if (this->curr_cycle == 0) {
+		return false;
+	}
+	
+	// Without the register of every cycle, execute again from a checkpoint
+	if (!this->model->step_back()) {
+		this->seek(this->curr_cycle - 1);
+		return true;
+	}
+	this->curr_cycle--;
+	
+	return true;
+}
+
+/**
+ * Go to a cycle, executing the cycles that were not executed yet (or that
+ * can not be replayed from the history)
+ * @param cycle
+ */
+void CrossbarSimulator::seek(int cycle) {
+	cycle = std::max(0, std::min(cycle, this->num_cycles));
+	
+	this->model->seek(cycle);
+	this->curr_cycle = this->model->get_history_cycle();
+	while (this->curr_cycle < cycle && this->step());
+}
+
+/**
+ * Rewind to the initial crossbar (the program is kept). While simulating,
+ * the history only keeps the register in its checkpoints.
+ */
+void CrossbarSimulator::reset() {
+	delete this->model;
+	this->model = this->initial_model->clone();
+	if (this->model->is_simulating()) {
+		this->model->start_history(STATE_CHECKPOINT_INTERVAL);
+	} else {
+		this->model->start_history();
+	}
+	this->curr_cycle = 0;
+}
+
+int CrossbarSimulator::get_cycle() const {
+	return this->curr_cycle;
+}
+
+int CrossbarSimulator::get_num_cycles() const {
+	return this->num_cycles;
+}
+
+std::tuple<int, int> CrossbarSimulator::get_dimensions() {
+	return this->model->get_dimensions();
+}
+
+std::tuple<int, int> CrossbarSimulator::get_position(int q_id) {
+	QubitPosition* pos = this->model->get_position(q_id);
+	if (pos == NULL) {
+		throw std::runtime_error("Qubit " + std::to_string(q_id) + " does not exist");
+	}
+	return std::make_tuple(pos->get_i(), pos->get_j());
+}
+
+const std::set<int>& CrossbarSimulator::get_qubits(int i, int j) {
+	return this->model->get_qubits(i, j);
+}
+
+const CrossbarSolution& CrossbarSimulator::get_solution() {
+	return this->model->get_constraint_solution();
+}
+
+/**
+ * @return amplitudes of the crossbar being stepped (NULL if not simulating)
+ */
+const StateVector* CrossbarSimulator::get_state_vector() {
+	return this->model->get_state_vector();
+}
+
+const std::map<int, int>& CrossbarSimulator::get_measurements() {
+	return this->model->get_measurements();
+}
+
+CrossbarModel* CrossbarSimulator::get_model() {
+	return this->model;
+}
+
+void CrossbarSimulator::release_program() {
+	for (std::vector<Operation*>& p_operations : this->operations) {
+		for (Operation* operation : p_operations) {
+			delete operation;
+		}
+	}
+	this->operations.clear();
+	this->timeline = Timeline();
+	this->num_cycles = 0;
+}
@@ -0,0 +1,95 @@
+#ifndef CROSSBAR_SIMULATOR_API_H
+#define CROSSBAR_SIMULATOR_API_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <nlohmann/json.hpp>
+
+#include "crossbar/CrossbarModel.h"
+#include "crossbar/CrossbarSolution.h"
+#include "crossbar/Scheduler.h"
+#include "crossbar/Timeline.h"
+#include "crossbar/operations/Operation.h"
+
+/**
+ * Result of validating a program (and the outcome of every measured
+ * qubit when simulating, and the probability that each qubit has had
+ * an error when the topology has noise)
+ */
+struct ValidationResult {
+	bool valid;
+	std::string message;
+	std::map<int, int> measurements;
+	std::map<int, double> errors;
+};
+
+/**
+ * Shots of the measured qubits of a valid program: character k of every
+ * outcome is the outcome of qubits[k]
+ */
+struct SampleResult {
+	bool valid;
+	std::string message;
+	std::vector<int> qubits;
+	std::map<std::string, int> counts;
+};
+
+/**
+ * Entry point of the simulator core for embedding: build a crossbar,
+ * load a cQASM program, validate it or step through it and query the state.
+ */
+class CrossbarSimulator {
+public:
+	CrossbarSimulator(int m, int n, int data_qubits, int ancilla_qubits);
+	CrossbarSimulator(const nlohmann::json& topology);
+	
+	~CrossbarSimulator();
+	
+	static CrossbarSimulator* from_topology_file(const std::string& path);
+	
+	void set_backend(const std::string& name);
+	void set_simulation(bool enabled, int num_threads = 0, const std::string& backend = "statevector");
+	void set_seed(uint64_t seed);
+	void set_timing(const TimingTable& timing);
+	
+	// Program
+	void load_program(const std::string& text);
+	ScheduleResult schedule();
+	ValidationResult validate(std::ostream* report = NULL);
+	SampleResult sample(int shots, uint64_t seed = 0, int num_threads = 0);
+	bool step();
+	bool step_back();
+	void seek(int cycle);
+	void reset();
+	
+	// State
+	int get_cycle() const;
+	int get_num_cycles() const;
+	std::tuple<int, int> get_dimensions();
+	std::tuple<int, int> get_position(int q_id);
+	const std::set<int>& get_qubits(int i, int j);
+	const CrossbarSolution& get_solution();
+	const StateVector* get_state_vector();
+	const std::map<int, int>& get_measurements();
+	CrossbarModel* get_model();
+	
+private:
+	// Cycles between the copies of the register kept to step back
+	static const int STATE_CHECKPOINT_INTERVAL = 64;
+	
+	// Initial crossbar and the one being stepped
+	CrossbarModel* initial_model;
+	CrossbarModel* model;
+	
+	std::vector<std::vector<Operation*> > operations;
+	Timeline timeline;
+	int curr_cycle;
+	int num_cycles;
+	
+	void release_program();
+};
+
+#endif /* CROSSBAR_SIMULATOR_API_H */
@@ -0,0 +1,127 @@
+#include <algorithm>
+
+#include "WorkStealingPool.h"
+
+/**
+ * @param num_threads number of workers (0: one per hardware thread)
+ */
+WorkStealingPool::WorkStealingPool(int num_threads) {
+	if (num_threads <= 0) {
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	
+	this->queued = 0;
+	this->pending = 0;
+	this->next_queue = 0;
+	this->stopping = false;
+	
+	for (int k = 0; k < num_threads; k++) {
+		this->queues.push_back(std::unique_ptr<Queue>(new Queue()));
+	}
+	for (int k = 0; k < num_threads; k++) {
+		this->threads.push_back(std::thread(&WorkStealingPool::run, this, k));
+	}
+}
+
+WorkStealingPool::~WorkStealingPool() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->work_available.notify_all();
+	
+	for (std::thread& thread : this->threads) {
+		thread.join();
+	}
+}
+
+/**
+ * Add a task. The task gets the index of the worker that runs it.
+ * @param task
+ */
+void WorkStealingPool::submit(std::function<void(int)> task) {
+	int worker;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		worker = this->next_queue;
+		this->next_queue = (this->next_queue + 1) % this->queues.size();
+		this->queued++;
+		this->pending++;
+	}
+	
+	{
+		std::lock_guard<std::mutex> lock(this->queues[worker]->mutex);
+		this->queues[worker]->tasks.push_back(task);
+	}
+	this->work_available.notify_one();
+}
+
+/**
+ * Block until every submitted task has finished
+ */
+void WorkStealingPool::wait() {
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->all_done.wait(lock, [this] { return this->pending == 0; });
+}
+
+int WorkStealingPool::get_num_threads() const {
+	return this->threads.size();
+}
+
+void WorkStealingPool::run(int worker) {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->work_available.wait(lock, [this] { return this->stopping || this->queued > 0; });
+			if (this->queued == 0) {
+				// Stopping and nothing left
+				return;
+			}
+			this->queued--;
+		}
+		
+		// A task is reserved for this worker, so some queue has it
+		std::function<void(int)> task;
+		while (!this->pop(worker, task)) {
+			std::this_thread::yield();
+		}
+		
+		task(worker);
+		
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->pending--;
+			if (this->pending == 0) {
+				this->all_done.notify_all();
+			}
+		}
+	}
+}
+
+/**
+ * Take the newest task of the own queue or steal the oldest of another one
+ */
+bool WorkStealingPool::pop(int worker, std::function<void(int)>& task) {
+	{
+		Queue* own = this->queues[worker].get();
+		std::lock_guard<std::mutex> lock(own->mutex);
+		if (!own->tasks.empty()) {
+			task = own->tasks.back();
+			own->tasks.pop_back();
+			return true;
+		}
+	}
+	
+	int size = this->queues.size();
+	for (int k = 1; k < size; k++) {
+		Queue* other = this->queues[(worker + k) % size].get();
+		std::lock_guard<std::mutex> lock(other->mutex);
+		if (!other->tasks.empty()) {
+			task = other->tasks.front();
+			other->tasks.pop_front();
+			return true;
+		}
+	}
+	
+	return false;
+}
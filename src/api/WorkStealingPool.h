@@ -0,0 +1,47 @@
+#ifndef CROSSBAR_SIMULATOR_WORKSTEALINGPOOL_H
+#define CROSSBAR_SIMULATOR_WORKSTEALINGPOOL_H
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * Thread pool where every worker has its own queue of tasks and takes
+ * tasks from the other queues when its own is empty
+ */
+class WorkStealingPool {
+public:
+	WorkStealingPool(int num_threads = 0);
+	~WorkStealingPool();
+	
+	void submit(std::function<void(int)> task);
+	void wait();
+	
+	int get_num_threads() const;
+	
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<std::function<void(int)> > tasks;
+	};
+	
+	std::vector<std::unique_ptr<Queue> > queues;
+	std::vector<std::thread> threads;
+	
+	std::mutex mutex;
+	std::condition_variable work_available;
+	std::condition_variable all_done;
+	int queued;
+	int pending;
+	int next_queue;
+	bool stopping;
+	
+	void run(int worker);
+	bool pop(int worker, std::function<void(int)>& task);
+};
+
+#endif /* CROSSBAR_SIMULATOR_WORKSTEALINGPOOL_H */
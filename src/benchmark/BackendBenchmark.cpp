@@ -0,0 +1,71 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "crossbar/CrossbarModel.h"
+#include "crossbar/ConstraintChecker.h"
+#include "crossbar/solvers/ConstraintBackend.h"
+#include "parser/CQASMParser.h"
+
+/**
+ * Compare the constraint backends on the same programs.
+ * Usage: crossbar-benchmark <size> <repetitions> <file.qasm>...
+ */
+int main(int argc, char **argv) {
+	if (argc < 4) {
+		std::cerr << "Usage: " << argv[0] << " <size> <repetitions> <file.qasm>..." << std::endl;
+		return 1;
+	}
+	
+	int size = std::stoi(argv[1]);
+	int repetitions = std::stoi(argv[2]);
+	
+	for (int f = 3; f < argc; f++) {
+		std::ifstream file(argv[f]);
+		if (!file) {
+			std::cerr << "Can not open " << argv[f] << std::endl;
+			return 1;
+		}
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		std::string text = buffer.str();
+		
+		for (const std::string& name : ConstraintBackend::get_names()) {
+			double total_ms = 0;
+			std::string result = "VALID";
+			
+			for (int r = 0; r < repetitions; r++) {
+				int num_qubits = CQASMParser::get_num_qubits(text);
+				std::vector<std::vector<Operation*> > operations = CQASMParser::parse(text);
+				
+				CrossbarModel* model = new CrossbarModel(size, num_qubits, 0);
+				model->set_constraint_backend(name);
+				
+				auto start = std::chrono::steady_clock::now();
+				try {
+					ConstraintChecker::validate(model, operations);
+				} catch (const std::exception& ex) {
+					result = ex.what();
+				}
+				auto end = std::chrono::steady_clock::now();
+				total_ms += std::chrono::duration<double, std::milli>(end - start).count();
+				
+				delete model;
+				for (std::vector<Operation*>& p_operations : operations) {
+					for (Operation* operation : p_operations) {
+						delete operation;
+					}
+				}
+			}
+			
+			std::cout << argv[f] << "\t" << name << "\t"
+					<< (total_ms / repetitions) << " ms\t" << result << std::endl;
+		}
+	}
+	
+	return 0;
+}
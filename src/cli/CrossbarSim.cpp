@@ -0,0 +1,216 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "api/CrossbarSimulator.h"
+#include "api/BatchValidator.h"
+#include "parser/TopologyLoader.h"
+
+static void usage(const char* name) {
+	std::cerr << "Usage: " << name << " [-b naxos|difference|auto] [-q] [-a] [-s [statevector|stabilizer]] [-n shots] [-r seed] [-j threads] <topology.json> <file.qasm>..." << std::endl;
+}
+
+/**
+ * Print the number of shots of every outcome of the measured qubits
+ */
+static void print_shots(CrossbarSimulator* simulator, int shots, uint64_t seed, int num_threads) {
+	SampleResult result = simulator->sample(shots, seed, num_threads);
+	if (!result.valid) {
+		std::cout << "  shots: " << result.message << std::endl;
+		return;
+	}
+	
+	std::cout << "  shots of";
+	for (int q_id : result.qubits) {
+		std::cout << " q" << q_id;
+	}
+	std::cout << std::endl;
+	for (auto const &entry : result.counts) {
+		std::cout << "  " << entry.first << " " << entry.second << std::endl;
+	}
+}
+
+/**
+ * Validate one program on the initial crossbar (and draw its shots)
+ * @return true if the program is valid
+ */
+static bool validate_file(CrossbarSimulator* simulator, const std::string& path, bool quiet, bool schedule,
+		int shots, uint64_t seed, int num_threads) {
+	std::ifstream file(path);
+	if (!file) {
+		std::cout << path << ": INVALID (unable to open file)" << std::endl;
+		return false;
+	}
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	
+	ValidationResult result;
+	try {
+		simulator->load_program(buffer.str());
+		if (schedule) {
+			ScheduleResult scheduled = simulator->schedule();
+			std::cout << path << ": scheduled " << scheduled.cycles_before << " -> " << scheduled.cycles_after
+				<< " cycles (" << scheduled.bundles_before << " -> " << scheduled.bundles_after << " bundles)" << std::endl;
+		}
+		result = simulator->validate(quiet ? NULL : &std::cout);
+	} catch (const std::exception& ex) {
+		result = {false, ex.what()};
+	}
+	
+	if (result.valid) {
+		std::cout << path << ": VALID";
+		for (auto const &entry : result.measurements) {
+			std::cout << " q" << entry.first << "=" << entry.second;
+		}
+		std::cout << std::endl;
+		if (!result.errors.empty()) {
+			std::cout << "  error";
+			for (auto const &entry : result.errors) {
+				std::cout << " q" << entry.first << "=" << entry.second;
+			}
+			std::cout << std::endl;
+		}
+		if (shots > 0) {
+			print_shots(simulator, shots, seed, num_threads);
+		}
+	} else {
+		std::cout << path << ": INVALID (" << result.message << ")" << std::endl;
+	}
+	
+	return result.valid;
+}
+
+/**
+ * Validate all the programs on a thread pool (no per-cycle report)
+ * @return number of invalid programs
+ */
+static int validate_batch(const std::vector<std::string>& files, const std::string& backend, int num_threads) {
+	BatchValidator validator(TopologyLoader::read_file(files[0]), num_threads);
+	validator.set_backend(backend);
+	
+	// The files that can not be read are invalid without parsing them
+	std::vector<std::string> programs;
+	std::vector<std::string> names;
+	std::vector<bool> readable;
+	for (size_t k = 1; k < files.size(); k++) {
+		std::ifstream file(files[k]);
+		readable.push_back((bool) file);
+		if (!file) continue;
+		
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		programs.push_back(buffer.str());
+		names.push_back(files[k]);
+	}
+	std::vector<ProgramResult> results = validator.validate(programs, names);
+	
+	int invalid = 0;
+	size_t next_result = 0;
+	for (size_t k = 1; k < files.size(); k++) {
+		if (!readable[k - 1]) {
+			std::cout << files[k] << ": INVALID (unable to open file)" << std::endl;
+			invalid++;
+			continue;
+		}
+		
+		const ProgramResult& result = results[next_result++];
+		if (result.valid) {
+			std::cout << result.name << ": VALID";
+		} else {
+			std::cout << result.name << ": INVALID (" << result.message << ")";
+			invalid++;
+		}
+		std::cout << " [parse " << result.parse_ms << " ms, validate " << result.validate_ms << " ms]" << std::endl;
+	}
+	
+	return invalid;
+}
+
+/**
+ * Headless validation of cQASM programs
+ * @return 0 if every program is valid, 1 if any is invalid, 2 on bad usage
+ */
+int main(int argc, char **argv) {
+	std::string backend = "auto";
+	bool quiet = false;
+	bool schedule = false;
+	bool simulate = false;
+	std::string simulation_backend = "statevector";
+	int shots = 0;
+	bool has_shots = false;
+	uint64_t seed = 0;
+	int num_threads = 1;
+	std::vector<std::string> files;
+	
+	for (int k = 1; k < argc; k++) {
+		std::string arg = argv[k];
+		if (arg == "-b" && k + 1 < argc) {
+			backend = argv[++k];
+		} else if (arg == "-q") {
+			quiet = true;
+		} else if (arg == "-a") {
+			schedule = true;
+		} else if (arg == "-s") {
+			simulate = true;
+			if (k + 1 < argc && (std::string(argv[k + 1]) == "statevector" || std::string(argv[k + 1]) == "stabilizer")) {
+				simulation_backend = argv[++k];
+			}
+		} else if (arg == "-n" && k + 1 < argc) {
+			shots = std::stoi(argv[++k]);
+			has_shots = true;
+		} else if (arg == "-r" && k + 1 < argc) {
+			seed = std::stoull(argv[++k]);
+		} else if (arg == "-j" && k + 1 < argc) {
+			num_threads = std::stoi(argv[++k]);
+		} else if (arg == "-h" || arg == "--help") {
+			usage(argv[0]);
+			return 0;
+		} else {
+			files.push_back(arg);
+		}
+	}
+	
+	// Shots are drawn from the simulated register only
+	if (files.size() < 2 || (has_shots && !simulate)) {
+		usage(argv[0]);
+		return 2;
+	}
+	
+	if (num_threads != 1 && !simulate && !schedule) {
+		int invalid;
+		try {
+			invalid = validate_batch(files, backend, num_threads);
+		} catch (const std::exception& ex) {
+			std::cerr << ex.what() << std::endl;
+			return 2;
+		}
+		std::cout << (files.size() - 1 - invalid) << " valid, " << invalid << " invalid" << std::endl;
+		return invalid > 0 ? 1 : 0;
+	}
+	
+	CrossbarSimulator* simulator;
+	try {
+		simulator = CrossbarSimulator::from_topology_file(files[0]);
+		simulator->set_backend(backend);
+		simulator->set_simulation(simulate, num_threads, simulation_backend);
+		simulator->set_seed(seed);
+	} catch (const std::exception& ex) {
+		std::cerr << files[0] << ": " << ex.what() << std::endl;
+		return 2;
+	}
+	
+	int invalid = 0;
+	for (size_t k = 1; k < files.size(); k++) {
+		if (!validate_file(simulator, files[k], quiet, schedule, shots, seed, num_threads)) {
+			invalid++;
+		}
+	}
+	
+	std::cout << (files.size() - 1 - invalid) << " valid, " << invalid << " invalid" << std::endl;
+	
+	delete simulator;
+	return invalid > 0 ? 1 : 0;
+}
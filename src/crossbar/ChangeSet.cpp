@@ -0,0 +1,107 @@
+#include "ChangeSet.h"
+
+ChangeSet::ChangeSet() {
+	this->wave_changed = false;
+	this->all_changed = false;
+}
+
+void ChangeSet::add_h_line(int i) {
+	this->h_lines.insert(i);
+}
+
+void ChangeSet::add_v_line(int i) {
+	this->v_lines.insert(i);
+}
+
+void ChangeSet::add_d_line(int i) {
+	this->d_lines.insert(i);
+}
+
+void ChangeSet::add_qubit(int q_id) {
+	this->qubits.insert(q_id);
+}
+
+/**
+ * Moves of the same qubit are joined into one
+ */
+void ChangeSet::add_move(int q_id, int from_site, int to_site) {
+	this->qubits.insert(q_id);
+	auto it = this->moves.find(q_id);
+	if (it != this->moves.end()) {
+		it->second.to_site = to_site;
+	} else {
+		this->moves[q_id] = {from_site, to_site};
+	}
+}
+
+void ChangeSet::set_wave_changed() {
+	this->wave_changed = true;
+}
+
+/**
+ * Everything may have changed (the lists are dropped)
+ */
+void ChangeSet::set_all_changed() {
+	this->clear();
+	this->all_changed = true;
+}
+
+void ChangeSet::merge(const ChangeSet& other) {
+	if (this->all_changed) return;
+	if (other.all_changed) {
+		this->set_all_changed();
+		return;
+	}
+	
+	this->h_lines.insert(other.h_lines.begin(), other.h_lines.end());
+	this->v_lines.insert(other.v_lines.begin(), other.v_lines.end());
+	this->d_lines.insert(other.d_lines.begin(), other.d_lines.end());
+	this->qubits.insert(other.qubits.begin(), other.qubits.end());
+	for (auto const &entry : other.moves) {
+		this->add_move(entry.first, entry.second.from_site, entry.second.to_site);
+	}
+	this->wave_changed = this->wave_changed || other.wave_changed;
+}
+
+void ChangeSet::clear() {
+	this->h_lines.clear();
+	this->v_lines.clear();
+	this->d_lines.clear();
+	this->qubits.clear();
+	this->moves.clear();
+	this->wave_changed = false;
+	this->all_changed = false;
+}
+
+bool ChangeSet::empty() const {
+	return !this->all_changed && !this->wave_changed && this->h_lines.empty()
+		&& this->v_lines.empty() && this->d_lines.empty() && this->qubits.empty();
+}
+
+const std::set<int>& ChangeSet::get_h_lines() const {
+	return this->h_lines;
+}
+
+const std::set<int>& ChangeSet::get_v_lines() const {
+	return this->v_lines;
+}
+
+const std::set<int>& ChangeSet::get_d_lines() const {
+	return this->d_lines;
+}
+
+const std::set<int>& ChangeSet::get_qubits() const {
+	return this->qubits;
+}
+
+const std::map<int, ChangeSet::Move>& ChangeSet::get_moves() const {
+	return this->moves;
+}
+
+bool ChangeSet::is_wave_changed() const {
+	return this->wave_changed;
+}
+
+bool ChangeSet::is_all_changed() const {
+	return this->all_changed;
+}
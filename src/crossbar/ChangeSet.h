@@ -0,0 +1,53 @@
+#ifndef CROSSBAR_SIMULATOR_CHANGESET_H
+#define CROSSBAR_SIMULATOR_CHANGESET_H
+
+#include <map>
+#include <set>
+
+/**
+ * What changed in the crossbar since the last notification: the index
+ * of every RL (h), CL (v) and QL (d) line, the qubits (and where the
+ * moved ones came from and went to) and the wave. A full change
+ * (restore, resize...) does not list anything.
+ */
+class ChangeSet {
+public:
+	// Sites (i * n + j) before the first and after the last move
+	struct Move {
+		int from_site;
+		int to_site;
+	};
+	
+	ChangeSet();
+	
+	void add_h_line(int i);
+	void add_v_line(int i);
+	void add_d_line(int i);
+	void add_qubit(int q_id);
+	void add_move(int q_id, int from_site, int to_site);
+	void set_wave_changed();
+	void set_all_changed();
+	
+	void merge(const ChangeSet& other);
+	void clear();
+	bool empty() const;
+	
+	const std::set<int>& get_h_lines() const;
+	const std::set<int>& get_v_lines() const;
+	const std::set<int>& get_d_lines() const;
+	const std::set<int>& get_qubits() const;
+	const std::map<int, Move>& get_moves() const;
+	bool is_wave_changed() const;
+	bool is_all_changed() const;
+	
+private:
+	std::set<int> h_lines;
+	std::set<int> v_lines;
+	std::set<int> d_lines;
+	std::set<int> qubits;
+	std::map<int, Move> moves;
+	bool wave_changed;
+	bool all_changed;
+};
+
+#endif /* CROSSBAR_SIMULATOR_CHANGESET_H */
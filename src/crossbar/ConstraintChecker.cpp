@@ -1,128 +1,179 @@
 #include "ConstraintChecker.h"
 
 /**
- * Get intervals by parallel operations.
+ * Validates the list of parallel operations
+ * @param model
  * @param operations
- * @return intervals of operations
+ * @param report where the result of each cycle is written (optional)
+ * @return the line number with the constraint error, if any
  */
-Intervals::IntervalTree<int, Operation*> ConstraintChecker::get_intervals_by_operations(std::vector<std::vector<Operation*> > operations) {
-	Intervals::IntervalTree<int, Operation*> operations_interval;
+int ConstraintChecker::validate(CrossbarModel* model, const std::vector<std::vector<Operation*> >& operations, std::ostream* report) {
+	// First iteration to collect info about instructions and times
+	Timeline timeline(operations, model->get_timing());
 	
-	// TODO: get value from JSON file
-	int CYCLE_TIME = 10;
+	return ConstraintChecker::validate(model, timeline, report);
+}
+
+/**
+ * Validates the operations placed on a timeline (e.g. by the scheduler)
+ * @param model
+ * @param timeline
+ * @param report where the result of each cycle is written (optional)
+ * @return the line number with the constraint error, if any
+ */
+int ConstraintChecker::validate(CrossbarModel* model, Timeline& timeline, std::ostream* report) {
+	// Signature of the last idle cycle
+	std::vector<uint64_t> idle_signature;
 	
-	int curr_cycle = 0;
-	for (std::vector<Operation*> p_operations : operations) {
-		// Check if wait operation
-		if (p_operations.size() == 1 && typeid(*p_operations.front()) == typeid(Wait)) {
-			Wait* wait_op = dynamic_cast<Wait*>(p_operations.front());
-			curr_cycle += wait_op->get_cycle_duration(CYCLE_TIME);
-			continue;
-		}
+	int num_cycles = timeline.get_num_cycles();
+	for (int curr_cycle = 0; curr_cycle < num_cycles; curr_cycle++) {
+		// Get the operations of the cycle
+		const std::vector<Timeline::Entry>& intervals = timeline.get_active(curr_cycle);
 		
-		// Insert in intervals
-		for (Operation* operation : p_operations) {
-			operations_interval.insert({curr_cycle, curr_cycle + operation->get_cycle_duration(CYCLE_TIME), operation});
+		// Once an idle cycle leaves the crossbar as it was, the next idle
+		// cycles only add noise
+		if (intervals.empty()) {
+			std::vector<uint64_t> signature = get_signature(model, intervals, curr_cycle);
+			if (signature == idle_signature) {
+				int next_cycle = timeline.get_next_start(curr_cycle);
+				model->apply_noise(next_cycle - curr_cycle);
+				if (report != NULL) {
+					*report << "cycles " << curr_cycle << "-" << (next_cycle - 1) << ": idle" << std::endl;
+				}
+				curr_cycle = next_cycle - 1;
+				continue;
+			}
+			idle_signature = signature;
+		} else {
+			idle_signature.clear();
 		}
 		
-		curr_cycle++;
+		ConstraintChecker::validate_cycle(model, intervals, curr_cycle, report);
 	}
 	
-	return operations_interval;
+	if (report != NULL) {
+		SolutionCache* cache = model->get_solution_cache();
+		*report << "Solution cache: " << cache->get_hits() << " hits, "
+				<< cache->get_misses() << " misses" << std::endl;
+	}
+	
+	return 0;
 }
 
 /**
- * Get the max cycle of all the intervals
- * @param intervals
- * @return 
+ * Check one cycle of a validation: execute the active operations, check
+ * the ones that start and solve the control lines of the cycle
+ * @param model crossbar before the cycle
+ * @param intervals operations active in the cycle
+ * @param curr_cycle
+ * @param report where the result of the cycle is written (optional)
+ * @throws std::runtime_error if a constraint can not be satisfied
  */
-int ConstraintChecker::max_cycle(Intervals::IntervalTree<int, Operation*> interval_tree) {
-	int max_cycle = 0;
-	for (const auto &interval : interval_tree.intervals()) {
-		if (interval.high > max_cycle) {
-			max_cycle = interval.high;
+void ConstraintChecker::validate_cycle(CrossbarModel* model, const std::vector<Timeline::Entry>& intervals,
+		int curr_cycle, std::ostream* report) {
+	// Try to execute always
+	for (const auto &interval : intervals) {
+		Operation* operation = interval.value;
+		operation->execute(model, curr_cycle - interval.low);
+	}
+	
+	// Operation is starting
+	for (const auto &interval : intervals) {
+		if (interval.low == curr_cycle) {
+			Operation* operation = interval.value;
+			try {
+				operation->check_static_constraints(model);
+			} catch (std::runtime_error e) {
+				throw std::runtime_error(std::string(e.what())
+						+ " at line " + std::to_string(operation->get_line_number()));
+			}
 		}
 	}
 	
-	return max_cycle + 1;
+	// Operation is executing
+	std::vector<Timeline::Entry> current_intervals;
+	for (const auto &interval : intervals) {
+		if (interval.high != curr_cycle) {
+			current_intervals.push_back(interval);
+		}
+	}
+
+	ConstraintChecker::solve_parameters(model, current_intervals, curr_cycle);
+	
+	// Apply the solution
+	ConstraintChecker::apply_solution(model);
+	model->apply_noise();
+	
+	if (report != NULL) {
+		ConstraintChecker::report_cycle(model, current_intervals.size(), curr_cycle, *report);
+	}
+	//if (model->get_active_wave() != 0 && this->model->get_wave_constraint()->value() == 0) {
+	//	model->toggle_wave(this->model->get_wave_column_constraint()->value());
+	//}
 }
 
 /**
- * Validates the list of parallel operations
+ * Execute one cycle and set the control lines for it
  * @param model
- * @param operations
- * @return the line number with the constraint error, if any
+ * @param operations_interval
+ * @param curr_cycle
  */
-int ConstraintChecker::validate(CrossbarModel* model, std::vector<std::vector<Operation*> > operations) {
-	// Get params
-	int m, n;
-	std::tie(m, n) = model->get_dimensions();
+void ConstraintChecker::step(CrossbarModel* model, Timeline& timeline, int curr_cycle) {
+	// The subscribers see the whole cycle at once
+	ChangeBatch batch(model);
 	
-	// First iteration to collect info about instructions and times
-	Intervals::IntervalTree<int, Operation*> operations_interval = get_intervals_by_operations(operations);
+	// Get the operations of the cycle
+	const std::vector<Timeline::Entry>& intervals = timeline.get_active(curr_cycle);
 	
-	int max_cycle = ConstraintChecker::max_cycle(operations_interval);
-	for (int curr_cycle = 0; curr_cycle < max_cycle; curr_cycle++) {
-		// Get intersected intervals
-		const auto &intervals = operations_interval.findIntervalsContainPoint(curr_cycle);
-		
-		// Try to execute always
-		for (const auto &interval : intervals) {
-			if (interval.low <= curr_cycle && interval.high >= curr_cycle) {
-				Operation* operation = interval.value;
-				operation->execute(model, curr_cycle - interval.low);
-			}
-		}
-		
-		// Operation is starting
-		for (const auto &interval : intervals) {
-			if (interval.low == curr_cycle) {
-				Operation* operation = interval.value;
-				try {
-					operation->check_static_constraints(model);
-				} catch (std::runtime_error e) {
-					throw std::runtime_error(std::string(e.what())
-							+ " at line " + std::to_string(operation->get_line_number()));
-				}
-			}
-		}
-		
-		// Operation is executing
-		std::vector<Intervals::Interval<int, Operation*> > current_intervals;
-		for (const auto &interval : intervals) {
-			if (interval.high != curr_cycle) {
-				current_intervals.push_back(interval);
-			}
-		}
-
-		std::cout << current_intervals.size() << std::endl << std::flush;
-		ConstraintChecker::solve_parameters(model, current_intervals, curr_cycle);
-		
-		// Apply the solution
-		for (int k = 0; k < m - 1; k++) {
-			if (model->get_h_line_constraint(k)->value() == 0) {
-				model->raise_h_line(k);
-			} else {
-				model->lower_h_line(k);
-			}
-
-			if (model->get_v_line_constraint(k)->value() == 0) {
-				model->raise_v_line(k);
-			} else {
-				model->lower_v_line(k);
-			}
-		}
-		for (int k = -1 * (m - 1); k <= (m - 1); k++) {
-			if (model->get_d_line(k) != model->get_d_line_constraint(k)->value()) {
-				model->set_d_line(k, model->get_d_line_constraint(k)->value());
-			}
+	// Try to execute always
+	for (const auto &interval : intervals) {
+		Operation* operation = interval.value;
+		operation->execute(model, curr_cycle - interval.low);
+	}
+	
+	// Find solution to dynamic constraints of starting and middle
+	std::vector<Timeline::Entry> current_intervals;
+	for (const auto &interval : intervals) {
+		if (interval.high != curr_cycle) {
+			current_intervals.push_back(interval);
 		}
-		//if (model->get_active_wave() != 0 && this->model->get_wave_constraint()->value() == 0) {
-		//	model->toggle_wave(this->model->get_wave_column_constraint()->value());
-		//}
 	}
 	
-	return 0;
+	ConstraintChecker::solve_parameters(model, current_intervals, curr_cycle);
+	
+	// Apply the solution
+	ConstraintChecker::apply_solution(model);
+	const CrossbarSolution& solution = model->get_constraint_solution();
+	if ((model->get_active_wave() == 0 && solution.get_wave() != 0)
+		|| (model->get_active_wave() != 0 && solution.get_wave() == 0)) { 
+		model->toggle_wave(solution.get_wave_column() == 0);
+	}
+	
+	model->apply_noise();
+	model->end_cycle();
+}
+
+/**
+ * Write the lowered barriers and QL voltages of a cycle
+ */
+void ConstraintChecker::report_cycle(CrossbarModel* model, int num_operations, int curr_cycle, std::ostream& report) {
+	int m, n;
+	std::tie(m, n) = model->get_dimensions();
+	const CrossbarSolution& solution = model->get_constraint_solution();
+	
+	report << "cycle " << curr_cycle << ": " << num_operations << " operations, RL down [";
+	for (int k = 0; k < m - 1; k++) {
+		if (solution.get_h_line(k) == 1) report << " " << k;
+	}
+	report << " ], CL down [";
+	for (int k = 0; k < n - 1; k++) {
+		if (solution.get_v_line(k) == 1) report << " " << k;
+	}
+	report << " ], QL [";
+	for (int k = -1 * (n - 1); k <= (m - 1); k++) {
+		report << " " << solution.get_d_line(k);
+	}
+	report << " ]" << std::endl;
 }
 
 /**
@@ -134,23 +185,16 @@ void ConstraintChecker::solve_parameters(CrossbarModel* model, std::vector<Inter
 	int m, n;
 	std::tie(m, n) = model->get_dimensions();
 	
-	// 1. Add dynamic constraints
-	model->add_constraints();
-	for (const auto &interval : intervals) {
-		Operation* operation = interval.value;
-		operation->add_dynamic_constraints(model, curr_cycle - interval.low);
+	// 0. Reuse the solution of an identical cycle
+	SolutionCache* cache = model->get_solution_cache();
+	std::vector<uint64_t> signature = get_signature(model, intervals, curr_cycle);
+	CrossbarSolution cached_solution;
+	if (cache->find(signature, cached_solution)) {
+		model->set_constraint_solution(cached_solution);
+		return;
 	}
 	
-	// Get the barriers that are going to be lowered
-	std::vector<int> h_line;
-	std::vector<int> v_line;
-	minimize_problem(model);
-	for (int k = 0; k < m - 1; k++) {
-		h_line.push_back(model->get_h_line_constraint(k)->value());
-		v_line.push_back(model->get_v_line_constraint(k)->value());
-	}
-	
-	// RE-add dynamic constraints
+	// 1. Collect the dynamic constraints
 	model->add_constraints();
 	std::vector<int> involved_qubits;
 	for (const auto &interval : intervals) {
@@ -161,60 +205,72 @@ void ConstraintChecker::solve_parameters(CrossbarModel* model, std::vector<Inter
 		involved_qubits.insert(involved_qubits.end(), qubits_involved.begin(), qubits_involved.end()); 
 	}
 	
-	naxos::NsProblemManager* pm = model->get_problem_manager();
+	// Get the barriers that are going to be lowered
+	CycleConstraints* constraints = model->get_cycle_constraints();
+	check_fixed_values(constraints);
+	std::vector<int> h_line;
+	std::vector<int> v_line;
+	solve_constraints(model, constraints);
+	const CrossbarSolution& barriers = model->get_constraint_solution();
+	for (int k = 0; k < m - 1; k++) {
+		h_line.push_back(barriers.get_h_line(k));
+	}
+	for (int k = 0; k < n - 1; k++) {
+		v_line.push_back(barriers.get_v_line(k));
+	}
 	
 	// 2. Get all qubits not involved in the dynamic constraints
+	// Only the occupied sites next to a lowered barrier are visited
+	const CrossbarBoard& board = model->get_board();
 	for (int k = 0; k < m - 1; k++) {
 		if (h_line[k] == 1) {
-			for (int j = 0; j < n; j++) {
+			bool vertical_pairs = board.rows_have_vertical_pair(k);
+			for (int j = board.next_occupied_in_rows(k, 0); j != -1; j = board.next_occupied_in_rows(k, j + 1)) {
 				// Get qubits
-				std::set<int> bottom_qubits = model->get_qubits(k, j);
-				std::set<int> top_qubits = model->get_qubits(k + 1, j);
+				const std::set<int>& bottom_qubits = model->get_qubits(k, j);
+				const std::set<int>& top_qubits = model->get_qubits(k + 1, j);
 
 				if (!contains(bottom_qubits, involved_qubits)
 					&& !contains(top_qubits, involved_qubits)) {
 					// Check for adjacent qubits
-					if (bottom_qubits.size() > 0 && top_qubits.size() > 0) {
+					if (vertical_pairs && bottom_qubits.size() > 0 && top_qubits.size() > 0) {
 						throw std::runtime_error("Two qubits vertically adjacent in line "
 								+ std::to_string(k));
 					}
 					// Check alone qubits
 					if ((bottom_qubits.size() + top_qubits.size()) == 1) {
-						naxos::NsIntVar* left_line = model->get_d_line_constraint(j - (k + 1));
-						naxos::NsIntVar* right_line = model->get_d_line_constraint(j - k);
-
 						if (bottom_qubits.size() > 0) {
-							pm->add(*left_line < *right_line);
+							constraints->compare_d_lines(j - (k + 1), LineConstraint::LESS, j - k);
 						} else {
-							pm->add(*left_line > *right_line);	
+							constraints->compare_d_lines(j - (k + 1), LineConstraint::GREATER, j - k);
 						}
 					}
 				}
 			}
 		}
-
+	}
+	
+	for (int k = 0; k < n - 1; k++) {
 		if (v_line[k] == 1) {
-			for (int i = 0; i < m; i++) {
+			bool horizontal_pairs = board.columns_have_horizontal_pair(k);
+			for (int i = board.next_occupied_in_columns(k, 0); i != -1; i = board.next_occupied_in_columns(k, i + 1)) {
 				// Get qubits
-				std::set<int> left_qubits = model->get_qubits(i, k);
-				std::set<int> right_qubits = model->get_qubits(i, k + 1);
+				const std::set<int>& left_qubits = model->get_qubits(i, k);
+				const std::set<int>& right_qubits = model->get_qubits(i, k + 1);
 
 				if (!contains(left_qubits, involved_qubits)
 					&& !contains(right_qubits, involved_qubits)) {
 					// Check for adjacent qubits
-					if (left_qubits.size() > 0 && right_qubits.size() > 0) {
+					if (horizontal_pairs && left_qubits.size() > 0 && right_qubits.size() > 0) {
 						throw std::runtime_error("Two qubits horizontally adjacent in line "
 								+ std::to_string(k));
 					}
 					// Check alone qubits
 					if ((left_qubits.size() + right_qubits.size()) == 1) {
-						naxos::NsIntVar* left_line = model->get_d_line_constraint(k - i);
-						naxos::NsIntVar* right_line = model->get_d_line_constraint((k + 1) - i);
-
 						if (left_qubits.size() > 0) {
-							pm->add(*left_line > *right_line);
+							constraints->compare_d_lines(k - i, LineConstraint::GREATER, (k + 1) - i);
 						} else {
-							pm->add(*left_line < *right_line);	
+							constraints->compare_d_lines(k - i, LineConstraint::LESS, (k + 1) - i);
 						}
 					}
 				}
@@ -223,48 +279,115 @@ void ConstraintChecker::solve_parameters(CrossbarModel* model, std::vector<Inter
 	}
 	
 	// 3. Get the best solution (preferable closed barriers and low voltage)
-	minimize_problem(model);
+	solve_constraints(model, constraints);
+	
+	cache->insert(signature, model->get_constraint_solution());
 }
 
-void ConstraintChecker::minimize_problem(CrossbarModel* model) {
-	// Get params
+/**
+ * Solve every independent group of constraints on its own and merge
+ * the results. Lines that no constraint touches keep their lowest value.
+ * @param model
+ * @param constraints
+ */
+void ConstraintChecker::solve_constraints(CrossbarModel* model, CycleConstraints* constraints) {
 	int m, n;
 	std::tie(m, n) = model->get_dimensions();
-	naxos::NsProblemManager* pm = model->get_problem_manager();
 	
-	// Add objective to minimize
-	naxos::NsIntVarArray vObjectiveTerms;
-	for (int k = 0; k < m - 1; k++) {
-		vObjectiveTerms.push_back(*model->get_h_line_constraint(k));
-		vObjectiveTerms.push_back(*model->get_v_line_constraint(k));
+	CrossbarSolution solution;
+	solution.reset(m, n);
+	
+	ConstraintBackend* backend = model->get_constraint_backend();
+	for (const std::vector<LineConstraint>& component : constraints->get_components()) {
+		backend->solve(component, solution);
 	}
-	for (int k = -1 * (n - 1); k <= (m - 1); k++) {
-		vObjectiveTerms.push_back(*model->get_d_line_constraint(k));
+	
+	model->set_constraint_solution(solution);
+}
+
+/**
+ * Fail before solving when two operations fix the same line (or site, or
+ * the wave) to different values: the lines they need follow from where
+ * their qubits are, so the conflict is known without the solver
+ * @param constraints
+ * @throws std::runtime_error if there is such a conflict
+ */
+void ConstraintChecker::check_fixed_values(const CycleConstraints* constraints) {
+	std::unordered_map<int, int> values;
+	for (const LineConstraint& constraint : constraints->get_constraints()) {
+		if (constraint.is_binary() || constraint.get_relation() != LineConstraint::EQUAL) continue;
+		
+		int variable = constraints->get_variable_id(constraint.get_type(), constraint.get_index());
+		auto it = values.insert(std::make_pair(variable, constraint.get_value())).first;
+		if (it->second != constraint.get_value()) {
+			throw std::runtime_error("Conflict between parallel operations");
+		}
 	}
-	vObjectiveTerms.push_back(*model->get_wave_constraint());
-	vObjectiveTerms.push_back(*model->get_wave_column_constraint());
+}
+
+/**
+ * Build the key of a cycle: occupancy, barriers and the active operations
+ * with their relative cycle and the position of their qubits
+ */
+std::vector<uint64_t> ConstraintChecker::get_signature(CrossbarModel* model,
+		const std::vector<Intervals::Interval<int, Operation*> >& intervals, int curr_cycle) {
+	int m, n;
+	std::tie(m, n) = model->get_dimensions();
 	
-	// Add labeling
-	pm->addGoal(new naxos::NsgLabeling(vObjectiveTerms));
+	std::vector<uint64_t> key = {(uint64_t) m, (uint64_t) n};
+	model->get_board().append_signature(key);
 	
-	try {
-		pm->minimize(naxos::NsSum(vObjectiveTerms));
-	} catch (...) {
-		// Ignore
-		std::cout << "Ignore error minimize" << std::endl << std::flush;
+	key.push_back(intervals.size());
+	for (const auto &interval : intervals) {
+		Operation* operation = interval.value;
+		key.push_back(typeid(*operation).hash_code());
+		key.push_back((uint64_t) (curr_cycle - interval.low));
+		
+		std::vector<int> parameters = operation->get_parameters();
+		key.push_back(parameters.size());
+		for (int parameter : parameters) {
+			key.push_back((uint64_t) parameter);
+		}
+		
+		std::vector<int> qubits = operation->get_involved_qubits();
+		key.push_back(qubits.size());
+		for (int q_id : qubits) {
+			QubitPosition* pos = model->get_position(q_id);
+			key.push_back((uint64_t) q_id);
+			key.push_back(pos != NULL ? (uint64_t) (pos->get_i() * n + pos->get_j()) : UINT64_MAX);
+		}
 	}
 	
-	if (!pm->nextSolution()) {
-		throw std::runtime_error("Conflict between parallel operations");
-	} else {
-		// Minimize
-		/*do {
-			// Save solution
-			model->save_constraint_solution();
-		} while (pm->nextSolution());*/
-		
-		// Restore solution
-		//model->restore_constraint_solution();
+	return key;
+}
+
+/**
+ * Set the control lines of the crossbar to the latest solution
+ * @param model
+ */
+void ConstraintChecker::apply_solution(CrossbarModel* model) {
+	int m, n;
+	std::tie(m, n) = model->get_dimensions();
+	const CrossbarSolution& solution = model->get_constraint_solution();
+	
+	for (int k = 0; k < m - 1; k++) {
+		if (solution.get_h_line(k) == 0) {
+			model->raise_h_line(k);
+		} else {
+			model->lower_h_line(k);
+		}
+	}
+	for (int k = 0; k < n - 1; k++) {
+		if (solution.get_v_line(k) == 0) {
+			model->raise_v_line(k);
+		} else {
+			model->lower_v_line(k);
+		}
+	}
+	for (int k = -1 * (n - 1); k <= (m - 1); k++) {
+		if (model->get_d_line(k) != solution.get_d_line(k)) {
+			model->set_d_line(k, solution.get_d_line(k));
+		}
 	}
 }
 
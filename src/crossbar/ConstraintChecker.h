@@ -2,11 +2,15 @@
 #define CONSTRAINTCHECKER_H
 
 #include <vector>
+#include <ostream>
+#include <typeinfo>
+#include <stdint.h>
 #include <algorithm>
-#include <naxos.h>
+#include <unordered_map>
 #include <interval-tree.h>
 
 #include "CrossbarModel.h"
+#include "Timeline.h"
 #include "operations/Operation.h"
 #include "operations/Shuttling.h"
 #include "operations/SingleGate.h"
@@ -14,17 +18,30 @@
 
 class ConstraintChecker {
 public:
-	static Intervals::IntervalTree<int, Operation*> get_intervals_by_operations(std::vector<std::vector<Operation*> > operations);
+	static int validate(CrossbarModel* model, const std::vector<std::vector<Operation*> >& operations,
+		std::ostream* report = NULL);
 	
-	static int max_cycle(Intervals::IntervalTree<int, Operation*> intervals);
+	static int validate(CrossbarModel* model, Timeline& timeline, std::ostream* report = NULL);
 	
-	static int validate(CrossbarModel* model, std::vector<std::vector<Operation*> > operations);
+	static void validate_cycle(CrossbarModel* model, const std::vector<Timeline::Entry>& intervals,
+		int curr_cycle, std::ostream* report = NULL);
 
 	static void solve_parameters(CrossbarModel* model,
 		std::vector<Intervals::Interval<int, Operation*> > intervals, int curr_cycle);
+	
+	static void apply_solution(CrossbarModel* model);
+	
+	static void step(CrossbarModel* model, Timeline& timeline, int curr_cycle);
 
 private:
-	static void minimize_problem(CrossbarModel* model);
+	static void report_cycle(CrossbarModel* model, int num_operations, int curr_cycle, std::ostream& report);
+	
+	static void solve_constraints(CrossbarModel* model, CycleConstraints* constraints);
+	
+	static void check_fixed_values(const CycleConstraints* constraints);
+	
+	static std::vector<uint64_t> get_signature(CrossbarModel* model,
+		const std::vector<Intervals::Interval<int, Operation*> >& intervals, int curr_cycle);
 	
 	static bool contains(std::set<int> qubits, std::vector<int> involved_qubits);
 };
@@ -0,0 +1,264 @@
+#include "CrossbarBoard.h"
+
+CrossbarBoard::CrossbarBoard() {
+	this->resize(0, 0);
+}
+
+/**
+ * Clear the board and set a new size
+ * @param m rows
+ * @param n columns
+ */
+void CrossbarBoard::resize(int m, int n) {
+	this->m = m;
+	this->n = n;
+	this->row_words = count_words(n);
+	this->column_words = count_words(m);
+	
+	this->rows.assign(m * this->row_words, 0);
+	this->columns.assign(n * this->column_words, 0);
+	this->h_barriers.assign(count_words(m - 1), 0);
+	this->v_barriers.assign(count_words(n - 1), 0);
+}
+
+void CrossbarBoard::set_occupied(int i, int j, bool occupied) {
+	set_bit(&this->rows[i * this->row_words], j, occupied);
+	set_bit(&this->columns[j * this->column_words], i, occupied);
+}
+
+bool CrossbarBoard::is_occupied(int i, int j) const {
+	return get_bit(&this->rows[i * this->row_words], j);
+}
+
+/**
+ * Check if any column has both sites in rows i and i + 1 occupied
+ */
+bool CrossbarBoard::rows_have_vertical_pair(int i) const {
+	if (i < 0 || i + 1 >= this->m) return false;
+	return intersects(&this->rows[i * this->row_words], &this->rows[(i + 1) * this->row_words], this->row_words);
+}
+
+/**
+ * Check if any row has both sites in columns j and j + 1 occupied
+ */
+bool CrossbarBoard::columns_have_horizontal_pair(int j) const {
+	if (j < 0 || j + 1 >= this->n) return false;
+	return intersects(&this->columns[j * this->column_words], &this->columns[(j + 1) * this->column_words], this->column_words);
+}
+
+/**
+ * Get the next column, from j on, with a qubit in row i or i + 1
+ * @return column of the site, or -1 if there is none left
+ */
+int CrossbarBoard::next_occupied_in_rows(int i, int j) const {
+	if (i < 0 || i + 1 >= this->m) return -1;
+	return next_in_union(&this->rows[i * this->row_words], &this->rows[(i + 1) * this->row_words], this->row_words, j);
+}
+
+/**
+ * Get the next row, from i on, with a qubit in column j or j + 1
+ * @return row of the site, or -1 if there is none left
+ */
+int CrossbarBoard::next_occupied_in_columns(int j, int i) const {
+	if (j < 0 || j + 1 >= this->n) return -1;
+	return next_in_union(&this->columns[j * this->column_words], &this->columns[(j + 1) * this->column_words], this->column_words, i);
+}
+
+void CrossbarBoard::set_h_barrier_down(int i, bool down) {
+	set_bit(this->h_barriers.data(), i, down);
+}
+
+void CrossbarBoard::set_v_barrier_down(int j, bool down) {
+	set_bit(this->v_barriers.data(), j, down);
+}
+
+bool CrossbarBoard::any_h_barrier_down() const {
+	return any(this->h_barriers.data(), this->h_barriers.size());
+}
+
+bool CrossbarBoard::any_v_barrier_down() const {
+	return any(this->v_barriers.data(), this->v_barriers.size());
+}
+
+/**
+ * Get the lowest horizontal barrier that is lowered
+ * @return index of the barrier, or -1 if all of them are raised
+ */
+int CrossbarBoard::first_h_barrier_down() const {
+	return first(this->h_barriers.data(), this->h_barriers.size());
+}
+
+/**
+ * Get the lowest vertical barrier that is lowered
+ * @return index of the barrier, or -1 if all of them are raised
+ */
+int CrossbarBoard::first_v_barrier_down() const {
+	return first(this->v_barriers.data(), this->v_barriers.size());
+}
+
+bool CrossbarBoard::has_adjacent_h_barriers_down() const {
+	return has_adjacent_pair(this->h_barriers.data(), this->h_barriers.size());
+}
+
+bool CrossbarBoard::has_adjacent_v_barriers_down() const {
+	return has_adjacent_pair(this->v_barriers.data(), this->v_barriers.size());
+}
+
+/**
+ * Find a qubit that faces more than one lowered barrier
+ * 
+ * Two consecutive lowered barriers k and k + 1 block the rows (or columns)
+ * k to k + 2, and a horizontal and a vertical barrier block the sites
+ * where the rows next to the first cross the columns next to the second.
+ * @param i row of the site found
+ * @param j column of the site found
+ * @return true if there is such a qubit
+ */
+bool CrossbarBoard::find_undecidable_site(int& i, int& j) const {
+	const uint64_t* h = this->h_barriers.data();
+	const uint64_t* v = this->v_barriers.data();
+	int h_words = this->h_barriers.size();
+	int v_words = this->v_barriers.size();
+	
+	if (this->has_adjacent_h_barriers_down()) {
+		for (int k = first(h, h_words); k != -1; k = next(h, h_words, k + 1)) {
+			if (k + 1 >= this->m - 1 || !get_bit(h, k + 1)) continue;
+			for (int r = k; r <= k + 2 && r < this->m; r++) {
+				int c = first(&this->rows[r * this->row_words], this->row_words);
+				if (c != -1) {
+					i = r;
+					j = c;
+					return true;
+				}
+			}
+		}
+	}
+	if (this->has_adjacent_v_barriers_down()) {
+		for (int k = first(v, v_words); k != -1; k = next(v, v_words, k + 1)) {
+			if (k + 1 >= this->n - 1 || !get_bit(v, k + 1)) continue;
+			for (int c = k; c <= k + 2 && c < this->n; c++) {
+				int r = first(&this->columns[c * this->column_words], this->column_words);
+				if (r != -1) {
+					i = r;
+					j = c;
+					return true;
+				}
+			}
+		}
+	}
+	if (!this->any_h_barrier_down() || !this->any_v_barrier_down()) {
+		return false;
+	}
+	
+	// Columns next to a lowered vertical barrier
+	std::vector<uint64_t> blocked_columns(this->row_words, 0);
+	for (int k = first(v, v_words); k != -1; k = next(v, v_words, k + 1)) {
+		set_bit(blocked_columns.data(), k, true);
+		set_bit(blocked_columns.data(), k + 1, true);
+	}
+	for (int k = first(h, h_words); k != -1; k = next(h, h_words, k + 1)) {
+		for (int r = k; r <= k + 1; r++) {
+			const uint64_t* row = &this->rows[r * this->row_words];
+			for (int w = 0; w < this->row_words; w++) {
+				uint64_t bits = row[w] & blocked_columns[w];
+				if (bits != 0) {
+					i = r;
+					j = w * WORD_BITS + __builtin_ctzll(bits);
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * Append the occupancy and the barriers to a cache key
+ */
+void CrossbarBoard::append_signature(std::vector<uint64_t>& key) const {
+	key.insert(key.end(), this->rows.begin(), this->rows.end());
+	key.insert(key.end(), this->h_barriers.begin(), this->h_barriers.end());
+	key.insert(key.end(), this->v_barriers.begin(), this->v_barriers.end());
+}
+
+int CrossbarBoard::count_words(int bits) {
+	if (bits <= 0) return 0;
+	return (bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+void CrossbarBoard::set_bit(uint64_t* words, int bit, bool value) {
+	uint64_t mask = uint64_t(1) << (bit % WORD_BITS);
+	if (value) {
+		words[bit / WORD_BITS] |= mask;
+	} else {
+		words[bit / WORD_BITS] &= ~mask;
+	}
+}
+
+bool CrossbarBoard::get_bit(const uint64_t* words, int bit) {
+	return (words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+}
+
+bool CrossbarBoard::any(const uint64_t* words, int count) {
+	for (int w = 0; w < count; w++) {
+		if (words[w] != 0) return true;
+	}
+	return false;
+}
+
+int CrossbarBoard::first(const uint64_t* words, int count) {
+	for (int w = 0; w < count; w++) {
+		if (words[w] != 0) {
+			return w * WORD_BITS + __builtin_ctzll(words[w]);
+		}
+	}
+	return -1;
+}
+
+/**
+ * Get the lowest set bit from the given one on
+ * @return index of the bit, or -1 if there is none
+ */
+int CrossbarBoard::next(const uint64_t* words, int count, int from) {
+	int w = from / WORD_BITS;
+	if (w >= count) return -1;
+	uint64_t word = words[w] & (~uint64_t(0) << (from % WORD_BITS));
+	while (word == 0) {
+		if (++w >= count) return -1;
+		word = words[w];
+	}
+	return w * WORD_BITS + __builtin_ctzll(word);
+}
+
+/**
+ * Get the lowest bit, from the given one on, set in either of the words
+ * @return index of the bit, or -1 if there is none
+ */
+int CrossbarBoard::next_in_union(const uint64_t* a, const uint64_t* b, int count, int from) {
+	int w = from / WORD_BITS;
+	if (w >= count) return -1;
+	uint64_t word = (a[w] | b[w]) & (~uint64_t(0) << (from % WORD_BITS));
+	while (word == 0) {
+		if (++w >= count) return -1;
+		word = a[w] | b[w];
+	}
+	return w * WORD_BITS + __builtin_ctzll(word);
+}
+
+/**
+ * Check for two consecutive set bits, including across word boundaries
+ */
+bool CrossbarBoard::has_adjacent_pair(const uint64_t* words, int count) {
+	for (int w = 0; w < count; w++) {
+		if (words[w] & (words[w] >> 1)) return true;
+		if (w + 1 < count && (words[w] >> (WORD_BITS - 1)) & words[w + 1] & 1) return true;
+	}
+	return false;
+}
+
+bool CrossbarBoard::intersects(const uint64_t* a, const uint64_t* b, int count) {
+	for (int w = 0; w < count; w++) {
+		if (a[w] & b[w]) return true;
+	}
+	return false;
+}
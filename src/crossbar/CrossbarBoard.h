@@ -0,0 +1,64 @@
+#ifndef CROSSBAR_SIMULATOR_CROSSBARBOARD_H
+#define CROSSBAR_SIMULATOR_CROSSBARBOARD_H
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Bitset view of the crossbar: occupancy per row/column and lowered barriers
+ */
+class CrossbarBoard {
+public:
+	CrossbarBoard();
+	
+	void resize(int m, int n);
+	
+	// Occupancy
+	void set_occupied(int i, int j, bool occupied);
+	bool is_occupied(int i, int j) const;
+	bool rows_have_vertical_pair(int i) const;
+	bool columns_have_horizontal_pair(int j) const;
+	int next_occupied_in_rows(int i, int j) const;
+	int next_occupied_in_columns(int j, int i) const;
+	
+	// Barriers
+	void set_h_barrier_down(int i, bool down);
+	void set_v_barrier_down(int j, bool down);
+	bool any_h_barrier_down() const;
+	bool any_v_barrier_down() const;
+	int first_h_barrier_down() const;
+	int first_v_barrier_down() const;
+	bool has_adjacent_h_barriers_down() const;
+	bool has_adjacent_v_barriers_down() const;
+	bool find_undecidable_site(int& i, int& j) const;
+	
+	void append_signature(std::vector<uint64_t>& key) const;
+	
+private:
+	static const int WORD_BITS = 64;
+	
+	int m;
+	int n;
+	int row_words;
+	int column_words;
+	
+	// Bit j of row i / bit i of column j
+	std::vector<uint64_t> rows;
+	std::vector<uint64_t> columns;
+	
+	// Bit k set when the barrier k is lowered
+	std::vector<uint64_t> h_barriers;
+	std::vector<uint64_t> v_barriers;
+	
+	static int count_words(int bits);
+	static void set_bit(uint64_t* words, int bit, bool value);
+	static bool get_bit(const uint64_t* words, int bit);
+	static bool any(const uint64_t* words, int count);
+	static int first(const uint64_t* words, int count);
+	static int next(const uint64_t* words, int count, int from);
+	static int next_in_union(const uint64_t* a, const uint64_t* b, int count, int from);
+	static bool has_adjacent_pair(const uint64_t* words, int count);
+	static bool intersects(const uint64_t* a, const uint64_t* b, int count);
+};
+
+#endif /* CROSSBAR_SIMULATOR_CROSSBARBOARD_H */
@@ -1,9 +1,10 @@
 #include <math.h>
 #include <string>
-#include <iostream>
 #include <stdexcept>
 #include <limits.h>
 #include "CrossbarModel.h"
+#include "simulation/StatevectorBackend.h"
+#include "simulation/ShotSampler.h"
 
 CrossbarModel::CrossbarModel(int m, int n, int data_qubits, int ancilla_qubits) {	
 	// Set the subscribers
@@ -18,136 +19,158 @@ CrossbarModel::CrossbarModel(int size, int data_qubits, int ancilla_qubits)
 	
 }
 
+CrossbarModel::CrossbarModel() {
+	this->subscribers = {};
+}
+
 CrossbarModel::~CrossbarModel() {
 	// Remove all subscribers
 	this->unsubscribeAll();
 	// Delete pointers
-	delete this->pm;
+	this->release_qubits();
+	delete this->constraint_backend;
+	delete this->history;
 }
 
+/**
+ * Copy of the crossbar without subscribers. The site table is shared
+ * until one of the copies moves a qubit, so cloning only copies the
+ * control lines and the qubits.
+ */
 CrossbarModel* CrossbarModel::clone() {
-	CrossbarModel* cloned_model = new CrossbarModel(this->m, this->n, 0, 0);
+	CrossbarModel* cloned_model = new CrossbarModel();
 	
-	for (auto const &barrier : this->h_lines) {
-		cloned_model->h_lines[barrier.first]->set_state(barrier.second->get_state());
-	}
-	for (auto const &barrier : this->v_lines) {
-		cloned_model->v_lines[barrier.first]->set_state(barrier.second->get_state());
-	}
-	for (auto const &ql_line : this->d_lines) {
-		cloned_model->d_lines[ql_line.first]->set_value(ql_line.second->get_value());
-	}
+	cloned_model->m = this->m;
+	cloned_model->n = this->n;
+	cloned_model->data_qubits = this->data_qubits;
+	cloned_model->ancilla_qubits = this->ancilla_qubits;
+	cloned_model->active_wave = this->active_wave;
+	
+	cloned_model->h_lines = this->h_lines;
+	cloned_model->v_lines = this->v_lines;
+	cloned_model->d_lines = this->d_lines;
+	cloned_model->positions_qubits = this->positions_qubits;
+	cloned_model->board = this->board;
+	cloned_model->quantum_state = this->quantum_state;
+	cloned_model->simulation_threads = this->simulation_threads;
+	cloned_model->stale_states = this->stale_states;
+	cloned_model->measurements = this->measurements;
+	cloned_model->random = this->random;
+	cloned_model->sampling = this->sampling;
+	cloned_model->sampled_qubits = this->sampled_qubits;
+	cloned_model->sampled_flips = this->sampled_flips;
+	cloned_model->timing = this->timing;
+	cloned_model->noise = this->noise;
+	cloned_model->shuttled_qubits = this->shuttled_qubits;
+	cloned_model->errors = this->errors;
+	cloned_model->frames = this->frames;
+	cloned_model->state_version = this->state_version;
 	
 	for (auto const &entry : this->qubits) {
-		int q_id = entry.first;
-		Qubit* qubit = entry.second;
-		cloned_model->add_qubit(q_id, new Qubit(
-			new QubitState(qubit->get_state()->get_alpha().real(), qubit->get_state()->get_beta().real()),
-			new QubitPosition(qubit->get_position()->get_i(), qubit->get_position()->get_j()),
-			qubit->get_is_ancillary()
-		));
+		cloned_model->qubits[entry.first] = new Qubit(*entry.second);
 	}
 	
-	//std::vector<Subscriber*> cloned_model->subscribers(this->subscribers);
-	
-	cloned_model->init_constraints();
+	cloned_model->cycle_constraints = CycleConstraints(this->m, this->n);
+	cloned_model->solution = this->solution;
+	cloned_model->constraint_backend = ConstraintBackend::create(this->constraint_backend->get_name());
 	
 	return cloned_model;
 }
 
-void CrossbarModel::init_constraints() {
-	if (this->pm != NULL) delete this->pm;
-	this->pm = new naxos::NsProblemManager();
+/**
+ * Get the site table to modify it, copying it first if it is shared
+ * with a clone
+ */
+std::vector<std::set<int> >& CrossbarModel::write_positions_qubits() {
+	if (this->positions_qubits.use_count() > 1) {
+		this->positions_qubits = std::make_shared<std::vector<std::set<int> > >(*this->positions_qubits);
+	}
+	return *this->positions_qubits;
 }
 
-void CrossbarModel::add_constraints() {
-	// Init constraints
-	this->init_constraints();
-	
-	// TODO: free memory
-	for (int i = 0; i <= m - 2; i++) {
-		this->h_lines_constraint[i] = new naxos::NsIntVar(*this->pm, 0, 1);
-	}
-	
-	for (int j = 0; j <= n - 2; j++) {
-		this->v_lines_constraint[j] = new naxos::NsIntVar(*this->pm, 0, 1);
-	}
-	
-	for (int k = -1 * (n - 1); k <= m; k++) {
-		this->d_lines_constraint[k] = new naxos::NsIntVar(*this->pm, 0, CrossbarModel::MAX_QL_VOLTAGE);
-	}
-	
-	for (int i = 0; i < m; ++i) {
-		this->position_qubits_constraint[i] = {};
-		for (int j = 0; j < n; ++j) {
-			/*this->position_qubits_constraint[i][j] = new naxos::NsIntVar(*this->pm, 0, 2);
-			this->pm->add(
-				*this->position_qubits_constraint[i][j] == this->positions_qubits[i][j].size()
-			);*/
-			this->position_qubits_constraint[i][j] = new naxos::NsIntVar(*this->pm, 0, 1000);
-		}
+/**
+ * Get the quantum state to modify it, copying it first if it is shared
+ * with a clone or the history
+ */
+QuantumBackend& CrossbarModel::write_quantum_state() {
+	if (this->quantum_state.use_count() > 1) {
+		this->quantum_state = std::shared_ptr<QuantumBackend>(this->quantum_state->clone());
 	}
-	
-	this->wave_constraint = new naxos::NsIntVar(*this->pm, 0, INT_MAX);
-	this->wave_column_constraint = new naxos::NsIntVar(*this->pm, 0, 1);
+	return *this->quantum_state;
 }
 
-int CrossbarModel::get_data_qubits() {
-	return this->data_qubits;
+/**
+ * Get the quantum state to read a qubit (any qubit if -1): it is only
+ * copied when the backend has to apply delayed gates on it first
+ */
+QuantumBackend& CrossbarModel::read_quantum_state(int q_id) {
+	if (this->quantum_state->has_pending_gates(q_id)) {
+		return this->write_quantum_state();
+	}
+	return *this->quantum_state;
 }
 
-int CrossbarModel::get_ancilla_qubits() {
-	return this->ancilla_qubits;
+void CrossbarModel::release_qubits() {
+	for (auto const &entry : this->qubits) {
+		delete entry.second;
+	}
+	this->qubits.clear();
 }
 
-naxos::NsProblemManager* CrossbarModel::get_problem_manager() {
-	return this->pm;
+/**
+ * Prepare the constraints of a new cycle
+ */
+void CrossbarModel::add_constraints() {
+	this->cycle_constraints.clear();
 }
 
-naxos::NsIntVar* CrossbarModel::get_h_line_constraint(int i) {
-	return this->h_lines_constraint[i];
+CycleConstraints* CrossbarModel::get_cycle_constraints() {
+	return &this->cycle_constraints;
 }
 
-naxos::NsIntVar* CrossbarModel::get_v_line_constraint(int i) {
-	return this->v_lines_constraint[i];
+ConstraintBackend* CrossbarModel::get_constraint_backend() {
+	return this->constraint_backend;
 }
 
-naxos::NsIntVar* CrossbarModel::get_d_line_constraint(int i) {
-	return this->d_lines_constraint[i];
+/**
+ * Select the solver of the constraints
+ * @param name "naxos", "difference" or "auto"
+ */
+void CrossbarModel::set_constraint_backend(const std::string& name) {
+	ConstraintBackend* backend = ConstraintBackend::create(name);
+	delete this->constraint_backend;
+	this->constraint_backend = backend;
+	this->solution_cache->clear();
 }
 
-std::map<int, std::map<int, naxos::NsIntVar*> > CrossbarModel::get_position_qubits_constraint() {
-	return this->position_qubits_constraint;
+int CrossbarModel::get_data_qubits() {
+	return this->data_qubits;
 }
 
-naxos::NsIntVar* CrossbarModel::get_position_qubits_constraint(int i, int j) {
-	return this->position_qubits_constraint[i][j];
+int CrossbarModel::get_ancilla_qubits() {
+	return this->ancilla_qubits;
 }
 
-naxos::NsIntVar* CrossbarModel::get_wave_constraint() {
-	return this->wave_constraint;
+const CrossbarSolution& CrossbarModel::get_constraint_solution() {
+	return this->solution;
 }
 
-naxos::NsIntVar* CrossbarModel::get_wave_column_constraint() {
-	return this->wave_column_constraint;
+void CrossbarModel::set_constraint_solution(const CrossbarSolution& solution) {
+	this->solution = solution;
 }
 
-void CrossbarModel::save_constraint_solution() {
-	backup_h_lines_constraint.insert(h_lines_constraint.begin(), h_lines_constraint.end());
-	backup_v_lines_constraint.insert(v_lines_constraint.begin(), v_lines_constraint.end());
-	backup_d_lines_constraint.insert(d_lines_constraint.begin(), d_lines_constraint.end());
-	backup_position_qubits_constraint.insert(position_qubits_constraint.begin(), position_qubits_constraint.end());
-	backup_wave_constraint = wave_constraint;
-	backup_wave_column_constraint = wave_column_constraint;
+SolutionCache* CrossbarModel::get_solution_cache() {
+	return this->solution_cache.get();
 }
 
-void CrossbarModel::restore_constraint_solution() {
-	h_lines_constraint.insert(backup_h_lines_constraint.begin(), backup_h_lines_constraint.end());
-	v_lines_constraint.insert(backup_v_lines_constraint.begin(), backup_v_lines_constraint.end());
-	d_lines_constraint.insert(backup_d_lines_constraint.begin(), backup_d_lines_constraint.end());
-	position_qubits_constraint.insert(backup_position_qubits_constraint.begin(), backup_position_qubits_constraint.end());
-	wave_constraint = backup_wave_constraint;
-	wave_column_constraint = backup_wave_column_constraint;
+/**
+ * Use the solution cache of another crossbar of the same size and solver
+ * (e.g. the copies of a search), so they reuse each other's solutions.
+ * Not thread safe: the crossbars must be used by the same thread.
+ * @param model
+ */
+void CrossbarModel::share_solution_cache(CrossbarModel* model) {
+	this->solution_cache = model->solution_cache;
 }
 
 /**
@@ -167,35 +190,35 @@ std::tuple<int, int, int> CrossbarModel::get_control_line_dimensions() {
 }
 
 bool CrossbarModel::is_h_barrier_up(int i) {
-	if (i < 0 || unsigned(i) > this->h_lines.size() - 1) {
+	if (i < 0 || i >= (int) this->h_lines.size()) {
 		return true;
 	}
-	return this->h_lines[i]->is_up();
+	return this->h_lines[i].is_up();
 }
 	
 bool CrossbarModel::is_v_barrier_up(int i) {
-	if (i < 0 || unsigned(i) > this->v_lines.size() - 1) {
+	if (i < 0 || i >= (int) this->v_lines.size()) {
 		return true;
 	}
-	return this->v_lines[i]->is_up();
+	return this->v_lines[i].is_up();
 }
 
 bool CrossbarModel::is_h_barrier_down(int i) {
-	if (i < 0 || unsigned(i) > this->h_lines.size() - 1) {
+	if (i < 0 || i >= (int) this->h_lines.size()) {
 		return false;
 	}
-	return this->h_lines[i]->is_down();
+	return this->h_lines[i].is_down();
 }
 
 bool CrossbarModel::is_v_barrier_down(int i) {
-	if (i < 0 || unsigned(i) > this->v_lines.size() - 1) {
+	if (i < 0 || i >= (int) this->v_lines.size()) {
 		return false;
 	}
-	return this->v_lines[i]->is_down();
+	return this->v_lines[i].is_down();
 }
 
 float CrossbarModel::get_d_line(int i) {
-	return this->d_lines[i]->get_value();
+	return this->get_d_line_ref(i).get_value();
 }
 
 /**
@@ -215,11 +238,82 @@ void CrossbarModel::unsubscribeAll() {
 }
 
 /**
- * Notify a change in control lines to all subscribers
+ * Notify all subscribers that anything may have changed
  */
 void CrossbarModel::notify_all() {
+	this->pending_changes.set_all_changed();
+	this->notify_changes();
+}
+
+/**
+ * Open a batch: the changes are collected until the matching
+ * commit_changes (batches can be nested)
+ */
+void CrossbarModel::begin_changes() {
+	this->batch_depth++;
+}
+
+/**
+ * Close a batch; the outermost one delivers all its changes at once
+ */
+void CrossbarModel::commit_changes() {
+	if (this->batch_depth > 0) {
+		this->batch_depth--;
+	}
+	this->notify_changes();
+}
+
+/**
+ * Sites touched by a set of changes: the rows or columns on both sides
+ * of a barrier, the sites of a QL diagonal and where the qubits are (and
+ * were before moving). A wave or a full change dirties every site.
+ * @param changes
+ */
+DirtyRegion CrossbarModel::get_dirty_region(const ChangeSet& changes) {
+	DirtyRegion region;
+	if (changes.is_all_changed() || changes.is_wave_changed()) {
+		region.add(0, 0, this->m - 1, this->n - 1);
+		return region;
+	}
+	
+	for (int k : changes.get_h_lines()) {
+		region.add(k, 0, k + 1, this->n - 1);
+	}
+	for (int k : changes.get_v_lines()) {
+		region.add(0, k, this->m - 1, k + 1);
+	}
+	for (int k : changes.get_d_lines()) {
+		// QL[k] runs over the sites with j - i = k
+		for (int i = std::max(0, -k); i < this->m && i + k < this->n; i++) {
+			region.add_site(i, i + k);
+		}
+	}
+	
+	const std::map<int, ChangeSet::Move>& moves = changes.get_moves();
+	for (int q_id : changes.get_qubits()) {
+		auto it = moves.find(q_id);
+		if (it != moves.end()) {
+			region.add_site(it->second.from_site / this->n, it->second.from_site % this->n);
+			region.add_site(it->second.to_site / this->n, it->second.to_site % this->n);
+		} else if (this->qubits.find(q_id) != this->qubits.end()) {
+			QubitPosition* pos = this->qubits[q_id]->get_position();
+			region.add_site(pos->get_i(), pos->get_j());
+		}
+	}
+	
+	return region;
+}
+
+/**
+ * Deliver the pending changes unless a batch is open
+ */
+void CrossbarModel::notify_changes() {
+	if (this->batch_depth > 0 || this->pending_changes.empty()) return;
+	
+	ChangeSet changes;
+	std::swap(changes, this->pending_changes);
 	for (Subscriber* sub : this->subscribers) {
-		sub->notified();
+		sub->notified_changes(changes);
 	}
 }
 
@@ -233,26 +327,31 @@ void CrossbarModel::notify_resize_all() {
 }
 
 void CrossbarModel::toggle_wave(bool is_even_column) {
+	int before = this->active_wave;
 	if (this->active_wave == 0) {
 		this->active_wave = (is_even_column) ? 2 : 1;
 	} else {
 		this->active_wave = 0;
 	}
-	this->notify_all();
+	this->record(StateDelta::WAVE, 0, before, this->active_wave);
+	this->pending_changes.set_wave_changed();
+	this->notify_changes();
 }
 
 void CrossbarModel::toggle_h_line(int i) {
-	this->h_lines[i]->toggle();
-	std::cout << "RL[" << std::to_string(i) << "] new value = "
-			<< std::to_string(this->h_lines[i]->get_state()).substr(0, 3) << std::endl << std::flush;
-	this->notify_all();
+	this->h_lines.at(i).toggle();
+	this->board.set_h_barrier_down(i, this->h_lines[i].is_down());
+	this->record(StateDelta::H_LINE, i, !this->h_lines[i].is_down(), this->h_lines[i].is_down());
+	this->pending_changes.add_h_line(i);
+	this->notify_changes();
 }
 
 void CrossbarModel::toggle_v_line(int i) {
-	this->v_lines[i]->toggle();
-	std::cout << "CL[" << std::to_string(i) << "] new value = "
-			<< std::to_string(this->v_lines[i]->get_state()).substr(0,3) << std::endl << std::flush;
-	this->notify_all();
+	this->v_lines.at(i).toggle();
+	this->board.set_v_barrier_down(i, this->v_lines[i].is_down());
+	this->record(StateDelta::V_LINE, i, !this->v_lines[i].is_down(), this->v_lines[i].is_down());
+	this->pending_changes.add_v_line(i);
+	this->notify_changes();
 }
 
 void CrossbarModel::lower_h_line(int i) {
@@ -280,13 +379,15 @@ void CrossbarModel::raise_v_line(int i) {
 }
 
 void CrossbarModel::set_d_line(int i, int new_value) {
-	std::cout << "QL[" << std::to_string(i) <<  "] new value: " << std::to_string(new_value) << std::endl << std::flush;
-	this->d_lines[i]->set_value(new_value);
-	this->notify_all();
+	QubitLine& line = this->get_d_line_ref(i);
+	this->record(StateDelta::D_LINE, i, line.get_value(), new_value);
+	line.set_value(new_value);
+	this->pending_changes.add_d_line(i);
+	this->notify_changes();
 }
 
 void CrossbarModel::change_d_line(int i, int (*func)(int)) {
-	int new_value = func(this->d_lines[i]->get_value());
+	int new_value = func(this->get_d_line_ref(i).get_value());
 	this->set_d_line(i, new_value);
 }
 
@@ -294,29 +395,17 @@ void CrossbarModel::change_d_line(int i, int (*func)(int)) {
  * Check if the configuration is valid
  */
 void CrossbarModel::check_valid_configuration() {
-	for (auto const &entry : this->iter_qubits_positions()) {
-		QubitPosition* pos = entry.second->get_position();
-		int i = pos->get_i();
-		int j = pos->get_j();
-		
-		// The target site has two or more open barriers
-		// | q : x : x |
-		if ((this->is_h_barrier_down(i) && this->is_h_barrier_down(i + 1))
-			|| (this->is_h_barrier_down(i - 1) && this->is_h_barrier_down(i - 2))) {
-			throw std::runtime_error("Undecidable configuration in (" + std::to_string(i) + ", " + std::to_string(j) + ")");
-		}
-		if ((this->is_v_barrier_down(j) && this->is_v_barrier_down(j + 1))
-			|| (this->is_v_barrier_down(j - 1) && this->is_v_barrier_down(j - 2))) {
-			throw std::runtime_error("Undecidable configuration in (" + std::to_string(i) + ", " + std::to_string(j) + ")");
-		}
-		// More than 2 open barriers
-		int count_barriers_down = int(this->is_h_barrier_down(i)) + int(this->is_h_barrier_down(i - 1)) 
-			+ int(this->is_v_barrier_down(j)) + int(this->is_v_barrier_down(j - 1));
-		if (count_barriers_down > 1) {
-			throw std::runtime_error("Undecidable configuration in (" + std::to_string(i) + ", " + std::to_string(j) + ")");
-		}
+	// Nothing to decide if every barrier is raised
+	if (!this->board.any_h_barrier_down() && !this->board.any_v_barrier_down()) {
+		return;
 	}
 	
+	// The target site has two or more open barriers
+	// | q : x : x |
+	int i, j;
+	if (this->board.find_undecidable_site(i, j)) {
+		throw std::runtime_error("Undecidable configuration in (" + std::to_string(i) + ", " + std::to_string(j) + ")");
+	}
 }
 
 /**
@@ -326,27 +415,30 @@ void CrossbarModel::evolve(std::vector<int> involved_qubits) {
 	// First, check any conflicts in the configuration
 	this->check_valid_configuration();
 	
+	// All the moves of the step in one notification
+	ChangeBatch batch(this);
+	
 	for (auto const &entry : this->iter_qubits_positions()) {
 		int q_id = entry.first;
 		QubitPosition* pos = entry.second->get_position();
 		
 		int i = pos->get_i();
 		int j = pos->get_j();
-		double d_line_top_val = this->d_lines[std::max((this->m - 1) * -1, j - i - 1)]->get_value();
-		double d_line_middle_val = this->d_lines[j - i]->get_value();
-		double d_line_bottom_val = this->d_lines[std::min(j - i + 1, (this->m - 1))]->get_value();
+		double d_line_top_val = this->get_d_line_ref(std::max((this->m - 1) * -1, j - i - 1)).get_value();
+		double d_line_middle_val = this->get_d_line_ref(j - i).get_value();
+		double d_line_bottom_val = this->get_d_line_ref(std::min(j - i + 1, (this->m - 1))).get_value();
 
 		if (d_line_top_val > d_line_middle_val) {
 			// Shuttle to the top
 			if (this->is_h_barrier_down(i)) {
 				if (this->contains(involved_qubits, q_id)) {
-					this->move_qubit(q_id, i + 1, j);
+					this->shuttle_qubit(q_id, i + 1, j);
 				}
 			}
 			// Shuttle to the left
 			if (this->is_v_barrier_down(j - 1)) {
 				if (this->contains(involved_qubits, q_id)) {
-					this->move_qubit(q_id, i, j - 1);
+					this->shuttle_qubit(q_id, i, j - 1);
 				}
 			}
 		}
@@ -355,19 +447,17 @@ void CrossbarModel::evolve(std::vector<int> involved_qubits) {
 			// Shuttle to the bottom
 			if (this->is_h_barrier_down(i - 1)) {
 				if (this->contains(involved_qubits, q_id)) {
-					this->move_qubit(q_id, i - 1, j);
+					this->shuttle_qubit(q_id, i - 1, j);
 				}
 			}
 			// Shuttle to the right
 			if (this->is_v_barrier_down(j)) {
 				if (this->contains(involved_qubits, q_id)) {
-					this->move_qubit(q_id, i, j + 1);
+					this->shuttle_qubit(q_id, i, j + 1);
 				}
 			}
 		}
 	}
-	
-	this->notify_all();
 }
 
 /**
@@ -384,17 +474,33 @@ void CrossbarModel::evolve() {
 	this->evolve(involved_qubits);
 }
 
+/**
+ * Move a qubit one site as part of the program (a shuttle step, which
+ * adds noise at the end of the cycle)
+ */
+void CrossbarModel::shuttle_qubit(int q_id, int i_dest, int j_dest) {
+	this->move_qubit(q_id, i_dest, j_dest);
+	this->shuttled_qubits.insert(q_id);
+}
+
 void CrossbarModel::move_qubit(int q_id, int i_dest, int j_dest) {
 	if (this->qubits.find(q_id) == this->qubits.end()) return;
 	if (i_dest < 0 || i_dest > this->m - 1) return;
 	if (j_dest < 0 || j_dest > this->n - 1) return;
 	
 	QubitPosition* pos = this->qubits[q_id]->get_position();
-	this->positions_qubits[pos->get_i()][pos->get_j()].erase(q_id);
-	this->positions_qubits[i_dest][j_dest].insert(q_id);
+	this->record(StateDelta::MOVE_QUBIT, q_id,
+		this->get_site(pos->get_i(), pos->get_j()), this->get_site(i_dest, j_dest));
+	std::vector<std::set<int> >& positions_qubits = this->write_positions_qubits();
+	std::set<int>& origin_site = positions_qubits[this->get_site(pos->get_i(), pos->get_j())];
+	origin_site.erase(q_id);
+	this->board.set_occupied(pos->get_i(), pos->get_j(), !origin_site.empty());
+	positions_qubits[this->get_site(i_dest, j_dest)].insert(q_id);
+	this->board.set_occupied(i_dest, j_dest, true);
+	this->pending_changes.add_move(q_id, this->get_site(pos->get_i(), pos->get_j()), this->get_site(i_dest, j_dest));
 	pos->set_i(i_dest);
 	pos->set_j(j_dest);
-	this->notify_all();
+	this->notify_changes();
 }
 
 /**
@@ -403,6 +509,8 @@ void CrossbarModel::move_qubit(int q_id, int i_dest, int j_dest) {
 void CrossbarModel::apply_ql(int origin_i, int origin_j, int dest_i, int dest_j, int flag) {
 	// Depends on the shuttling
 	std::map<int, double> changed_d_lines = {};
+	// Value of each changed QL line before the shuttling
+	std::map<int, double> old_d_lines = {};
 	if (origin_j == dest_j) {
 		// Vertical
 		int top_i, bottom_i;
@@ -421,28 +529,33 @@ void CrossbarModel::apply_ql(int origin_i, int origin_j, int dest_i, int dest_j,
 				throw std::runtime_error("There are two qubits in the same column " + std::to_string(j) + " while shuttling");
 			}*/
 			
+			QubitLine& top_line = this->get_d_line_ref(j - top_i);
+			QubitLine& bottom_line = this->get_d_line_ref(j - bottom_i);
+			old_d_lines.insert({j - top_i, top_line.get_value()});
+			old_d_lines.insert({j - bottom_i, bottom_line.get_value()});
+			
 			// Use default value
-			this->d_lines[j - top_i ]->set_value(default_value);
+			top_line.set_value(default_value);
 			
 			// Inverse strategy for the shuttling case
 			int shuttling_flag = (j == origin_j) ? flag : 1;
 			
-			if (!this->positions_qubits[top_i][j].empty()) {
+			if (!(*this->positions_qubits)[this->get_site(top_i, j)].empty()) {
 				// Right occupied
-				this->d_lines[j - bottom_i]->set_value(this->d_lines[j - top_i]->get_value() - (1 * shuttling_flag));
-			} else if (!this->positions_qubits[bottom_i][j].empty()) {
+				bottom_line.set_value(top_line.get_value() - (1 * shuttling_flag));
+			} else if (!(*this->positions_qubits)[this->get_site(bottom_i, j)].empty()) {
 				// Left occupied
-				this->d_lines[j - bottom_i]->set_value(this->d_lines[j - top_i]->get_value() + (1 * shuttling_flag));
+				bottom_line.set_value(top_line.get_value() + (1 * shuttling_flag));
 			} else {
 				// Both empty: do nothing
-				this->d_lines[j - bottom_i]->set_value(this->d_lines[j - top_i]->get_value());
+				bottom_line.set_value(top_line.get_value());
 			}
 			
 			// Update default value
-			default_value = this->d_lines[j - bottom_i]->get_value();
+			default_value = bottom_line.get_value();
 			
-			changed_d_lines[j - top_i] = this->d_lines[j - top_i]->get_value();
-			changed_d_lines[j - bottom_i] = this->d_lines[j - bottom_i]->get_value();
+			changed_d_lines[j - top_i] = top_line.get_value();
+			changed_d_lines[j - bottom_i] = bottom_line.get_value();
 		}
 	} else {
 		// Horizontal
@@ -462,28 +575,33 @@ void CrossbarModel::apply_ql(int origin_i, int origin_j, int dest_i, int dest_j,
 				throw std::runtime_error("There are two qubits in the same row " + std::to_string(i) + " while shuttling");
 			}*/
 			
+			QubitLine& right_line = this->get_d_line_ref(right_j - i);
+			QubitLine& left_line = this->get_d_line_ref(left_j - i);
+			old_d_lines.insert({right_j - i, right_line.get_value()});
+			old_d_lines.insert({left_j - i, left_line.get_value()});
+			
 			// Use default value
-			this->d_lines[right_j - i]->set_value(default_value);
+			right_line.set_value(default_value);
 			
 			// Inverse strategy for the shuttling case
 			int shuttling_flag = (i == origin_i) ? flag : 1;
 			
-			if (!this->positions_qubits[i][right_j].empty()) {
+			if (!(*this->positions_qubits)[this->get_site(i, right_j)].empty()) {
 				// Right occupied
-				this->d_lines[left_j - i]->set_value(this->d_lines[right_j - i]->get_value() - (1 * shuttling_flag));
-			} else if (!this->positions_qubits[i][left_j].empty()) {
+				left_line.set_value(right_line.get_value() - (1 * shuttling_flag));
+			} else if (!(*this->positions_qubits)[this->get_site(i, left_j)].empty()) {
 				// Left occupied
-				this->d_lines[left_j - i]->set_value(this->d_lines[right_j - i]->get_value() + (1 * shuttling_flag));
+				left_line.set_value(right_line.get_value() + (1 * shuttling_flag));
 			} else {
 				// Both empty: do nothing
-				this->d_lines[left_j - i]->set_value(this->d_lines[right_j - i]->get_value());
+				left_line.set_value(right_line.get_value());
 			}
 			
 			// Update default value
-			default_value = this->d_lines[left_j - i]->get_value();
+			default_value = left_line.get_value();
 			
-			changed_d_lines[right_j - i] = this->d_lines[right_j - i]->get_value();
-			changed_d_lines[left_j - i] = this->d_lines[left_j - i]->get_value();
+			changed_d_lines[right_j - i] = right_line.get_value();
+			changed_d_lines[left_j - i] = left_line.get_value();
 		}
 	}
 	
@@ -496,7 +614,16 @@ void CrossbarModel::apply_ql(int origin_i, int origin_j, int dest_i, int dest_j,
 		}
 	}
 	for (it = changed_d_lines.begin(); it != changed_d_lines.end(); it++) {
-		this->d_lines[it->first]->set_value(this->d_lines[it->first]->get_value() + (-1 * min_value));
+		QubitLine& d_line = this->get_d_line_ref(it->first);
+		d_line.set_value(d_line.get_value() + (-1 * min_value));
+	}
+	
+	for (it = old_d_lines.begin(); it != old_d_lines.end(); it++) {
+		double new_value = this->get_d_line_ref(it->first).get_value();
+		if (it->second != new_value) {
+			this->record(StateDelta::D_LINE, it->first, it->second, new_value);
+			this->pending_changes.add_d_line(it->first);
+		}
 	}
 }
 
@@ -512,10 +639,369 @@ int CrossbarModel::get_active_wave() {
 	return this->active_wave;
 }
 
+/**
+ * Simulate the quantum state of all the qubits from now on. The register
+ * starts as the product of the current state of every qubit.
+ * @param num_threads threads of the statevector kernels (0: one per core)
+ * @param backend "statevector" or "stabilizer" (Clifford gates only)
+ * @throws std::runtime_error if the backend can not hold the qubits
+ */
+void CrossbarModel::start_simulation(int num_threads, const std::string& backend) {
+	int num_bits = this->qubits.empty() ? 0 : this->qubits.rbegin()->first + 1;
+	std::vector<std::complex<double> > alphas(num_bits, 1);
+	std::vector<std::complex<double> > betas(num_bits, 0);
+	for (auto const &entry : this->qubits) {
+		alphas[entry.first] = entry.second->get_state()->get_alpha();
+		betas[entry.first] = entry.second->get_state()->get_beta();
+	}
+	
+	std::shared_ptr<QuantumBackend> state(QuantumBackend::create(backend, num_bits, num_threads));
+	state->set_product_state(alphas, betas);
+	this->quantum_state = state;
+	this->simulation_threads = num_threads;
+	this->measurements.clear();
+	this->sampled_qubits.clear();
+	this->stale_states.clear();
+	this->state_changed = true;
+}
+
+/**
+ * Stop simulating (every qubit keeps its last state)
+ */
+void CrossbarModel::stop_simulation() {
+	if (this->quantum_state != nullptr) {
+		for (auto const &entry : this->qubits) {
+			this->get_qubit_state(entry.first);
+		}
+	}
+	this->quantum_state.reset();
+	this->stale_states.clear();
+}
+
+bool CrossbarModel::is_simulating() {
+	return this->quantum_state != nullptr;
+}
+
+/**
+ * @return name of the quantum backend (empty if not simulating)
+ */
+std::string CrossbarModel::get_simulation_backend() {
+	return (this->quantum_state != nullptr) ? this->quantum_state->get_name() : "";
+}
+
+/**
+ * @return amplitudes with all the gates applied (NULL if not simulating
+ * with the statevector backend)
+ */
+const StateVector* CrossbarModel::get_state_vector() {
+	StatevectorBackend* backend = dynamic_cast<StatevectorBackend*>(this->quantum_state.get());
+	if (backend == NULL) return NULL;
+	
+	return &static_cast<StatevectorBackend&>(this->read_quantum_state()).get_state_vector();
+}
+
+/**
+ * @return probability of measuring |1> on a qubit (from its QubitState
+ * when not simulating)
+ */
+double CrossbarModel::get_probability_one(int q_id) {
+	if (this->quantum_state == nullptr) {
+		return std::norm(this->get_qubit(q_id)->get_state()->get_beta());
+	}
+	return this->read_quantum_state(q_id).get_probability_one(q_id);
+}
+
+/**
+ * Get the state of a qubit, brought up to date with the register
+ * @param q_id
+ * @return state (NULL if the qubit does not exist)
+ */
+QubitState* CrossbarModel::get_qubit_state(int q_id) {
+	Qubit* qubit = this->get_qubit(q_id);
+	if (qubit == NULL) return NULL;
+	
+	if (this->quantum_state != nullptr && this->stale_states.erase(q_id) > 0) {
+		this->sync_qubit_state(q_id);
+	}
+	return qubit->get_state();
+}
+
+/**
+ * Apply the one-qubit gates the backend has delayed (to fuse them)
+ */
+void CrossbarModel::flush_gates() {
+	if (this->quantum_state != nullptr && this->quantum_state->has_pending_gates()) {
+		this->write_quantum_state().flush();
+	}
+}
+
+/**
+ * Apply a one-qubit gate or preparation ("prep_x", "prep_y", "prep_z")
+ * to the register. Nothing changes when not simulating.
+ * @param gate cQASM name in lower case
+ * @param q_id
+ * @param angle rotation angle of "rx", "ry" and "rz"
+ * @throws std::runtime_error if the backend does not support the gate
+ */
+void CrossbarModel::apply_gate(const std::string& gate, int q_id, double angle) {
+	if (this->frames != nullptr) {
+		this->write_frames().apply_gate(gate, q_id);
+	}
+	if (this->quantum_state == nullptr) return;
+	this->check_not_sampled(q_id);
+	
+	QuantumBackend& state = this->write_quantum_state();
+	if (gate == "prep_x" || gate == "prep_y" || gate == "prep_z") {
+		if (state.measure(q_id, this->random.uniform()) == 1) state.apply_gate("x", q_id);
+		if (gate != "prep_z") state.apply_gate("h", q_id);
+		if (gate == "prep_y") state.apply_gate("s", q_id);
+	} else {
+		state.apply_gate(gate, q_id, angle);
+	}
+	
+	this->state_changed = true;
+	this->stale_states.insert(q_id);
+}
+
+void CrossbarModel::apply_cz(int q_a, int q_b) {
+	if (this->frames != nullptr) {
+		this->write_frames().apply_cz(q_a, q_b);
+	}
+	if (this->quantum_state == nullptr) return;
+	this->check_not_sampled(q_a);
+	this->check_not_sampled(q_b);
+	
+	this->write_quantum_state().apply_cz(q_a, q_b);
+	this->state_changed = true;
+	this->stale_states.insert(q_a);
+	this->stale_states.insert(q_b);
+}
+
+void CrossbarModel::apply_sqswap(int q_a, int q_b) {
+	if (this->quantum_state == nullptr) return;
+	this->check_not_sampled(q_a);
+	this->check_not_sampled(q_b);
+	
+	this->write_quantum_state().apply_sqswap(q_a, q_b);
+	this->state_changed = true;
+	this->stale_states.insert(q_a);
+	this->stale_states.insert(q_b);
+}
+
+/**
+ * Measure a qubit in the Z basis (collapses the state). In sampling mode
+ * the qubit is only marked as measured.
+ * @param q_id
+ * @return 0 or 1 (-1 in sampling mode)
+ */
+int CrossbarModel::measure(int q_id) {
+	int outcome;
+	if (this->sampling && this->quantum_state != nullptr) {
+		this->check_not_sampled(q_id);
+		this->sampled_qubits.push_back(q_id);
+		if (this->frames != nullptr) {
+			this->sampled_flips.push_back(this->frames->get_measurement_flips(q_id));
+		}
+		return -1;
+	} else if (this->quantum_state != nullptr) {
+		outcome = this->write_quantum_state().measure(q_id, this->random.uniform());
+		this->state_changed = true;
+		this->stale_states.erase(q_id);
+		
+		// The qubit is now in a basis state
+		QubitState* state = this->get_qubit(q_id)->get_state();
+		state->set_alpha(outcome ? 0 : 1);
+		state->set_beta(outcome ? 1 : 0);
+	} else {
+		QubitState* state = this->get_qubit(q_id)->get_state();
+		QubitState before = *state;
+		outcome = state->measure(this->random.uniform());
+		this->record_qubit_state(q_id, before);
+	}
+	
+	auto it = this->measurements.find(q_id);
+	this->record(StateDelta::MEASURE, q_id, (it != this->measurements.end()) ? it->second : -1, outcome);
+	this->measurements[q_id] = outcome;
+	return outcome;
+}
+
+const std::map<int, int>& CrossbarModel::get_measurements() {
+	return this->measurements;
+}
+
+/**
+ * Seed the outcomes of the measurements and preparations
+ * @param seed
+ */
+void CrossbarModel::set_seed(uint64_t seed) {
+	this->random.seed(seed);
+}
+
+/**
+ * Run the program once and draw the measurement outcomes afterwards with
+ * sample(). Only valid if no measured qubit is used again.
+ * @param enabled
+ * @param shots number of shots to draw, for their Pauli frames if the
+ * qubits are noisy (0: noiseless shots)
+ */
+void CrossbarModel::set_sampling(bool enabled, int shots) {
+	this->sampling = enabled;
+	this->sampled_qubits.clear();
+	this->sampled_flips.clear();
+	this->frames.reset();
+	
+	if (enabled && shots > 0 && this->has_noise()) {
+		int num_bits = this->qubits.empty() ? 0 : this->qubits.rbegin()->first + 1;
+		this->frames = std::make_shared<PauliFrames>(num_bits, shots);
+	}
+}
+
+const std::vector<int>& CrossbarModel::get_sampled_qubits() {
+	return this->sampled_qubits;
+}
+
+/**
+ * Draw shots of the qubits measured in sampling mode from the current state
+ * @param shots
+ * @param seed
+ * @param num_threads 0: one per core
+ * @return number of shots of every outcome, character k is the outcome
+ * of get_sampled_qubits()[k]
+ * @throws std::runtime_error if not simulating
+ */
+std::map<std::string, int> CrossbarModel::sample(int shots, uint64_t seed, int num_threads) {
+	if (this->quantum_state == nullptr) {
+		throw std::runtime_error("Sampling needs the quantum state simulation");
+	}
+	
+	if (this->frames != nullptr && this->frames->get_num_shots() != shots) {
+		throw std::runtime_error("The noise was simulated for " + std::to_string(this->frames->get_num_shots()) + " shots");
+	}
+	
+	ShotSampler sampler(&this->write_quantum_state(), this->sampled_qubits);
+	return sampler.sample(shots, seed, num_threads, (this->frames != nullptr) ? &this->sampled_flips : NULL);
+}
+
+/**
+ * Get the Pauli frames to modify them, copying them first if they are
+ * shared with a clone
+ */
+PauliFrames& CrossbarModel::write_frames() {
+	if (this->frames.use_count() > 1) {
+		this->frames = std::make_shared<PauliFrames>(*this->frames);
+	}
+	return *this->frames;
+}
+
+/**
+ * @param timing
+ * @throws std::runtime_error if an operation is too short for its steps
+ */
+void CrossbarModel::set_timing(const TimingTable& timing) {
+	timing.check();
+	this->timing = timing;
+	this->noise.set_cycle_time(timing.get_cycle_time());
+}
+
+const TimingTable& CrossbarModel::get_timing() {
+	return this->timing;
+}
+
+/**
+ * @param noise (its cycle time is the one of the timing)
+ */
+void CrossbarModel::set_noise_model(const NoiseModel& noise) {
+	this->noise = noise;
+	this->noise.set_cycle_time(this->timing.get_cycle_time());
+}
+
+const NoiseModel& CrossbarModel::get_noise_model() {
+	return this->noise;
+}
+
+/**
+ * @return true if any qubit can get an error
+ */
+bool CrossbarModel::has_noise() {
+	if (this->noise.get_relaxation_time() > 0 || this->noise.get_shuttle_error() > 0) return true;
+	for (auto const &entry : this->qubits) {
+		if (entry.second->get_dephasing_time() > 0) return true;
+	}
+	return false;
+}
+
+/**
+ * Add the errors of some cycles: decoherence of every qubit plus the
+ * shuttle steps of the last cycle. Updates the probability that each
+ * qubit has had an error and, when sampling, the Pauli frames of the shots.
+ * @param cycles number of cycles (the same as calling it once per cycle)
+ */
+void CrossbarModel::apply_noise(int cycles) {
+	for (auto const &entry : this->qubits) {
+		int q_id = entry.first;
+		double p_x, p_y, p_z;
+		this->noise.get_error_probabilities(entry.second->get_dephasing_time(),
+			this->shuttled_qubits.count(q_id) > 0, p_x, p_y, p_z);
+		
+		double p_error = p_x + p_y + p_z;
+		if (p_error <= 0) continue;
+		
+		double before = this->errors[q_id];
+		double after = 1 - (1 - before) * pow(1 - p_error, cycles);
+		this->record(StateDelta::ERROR, q_id, before, after);
+		this->errors[q_id] = after;
+		
+		// An independent flip repeated k times flips with (1 - (1 - 2p)^k) / 2
+		if (this->frames != nullptr) {
+			if (cycles > 1) {
+				p_x = (1 - pow(1 - 2 * p_x, cycles)) / 2;
+				p_y = (1 - pow(1 - 2 * p_y, cycles)) / 2;
+				p_z = (1 - pow(1 - 2 * p_z, cycles)) / 2;
+			}
+			this->write_frames().inject(q_id, p_x, p_y, p_z, this->random);
+		}
+	}
+	this->shuttled_qubits.clear();
+}
+
+const std::map<int, double>& CrossbarModel::get_errors() {
+	return this->errors;
+}
+
+void CrossbarModel::check_not_sampled(int q_id) {
+	if (std::find(this->sampled_qubits.begin(), this->sampled_qubits.end(), q_id) != this->sampled_qubits.end()) {
+		throw std::runtime_error(
+			"Qubit " + std::to_string(q_id) + " is used after its measurement, its shots can not be sampled"
+		);
+	}
+}
+
+/**
+ * Update the state of a qubit from the register. Only the magnitudes of
+ * the reduced state are kept (exact for |0> and |1>).
+ */
+void CrossbarModel::sync_qubit_state(int q_id) {
+	const double epsilon = 1e-12;
+	double probability_one = this->read_quantum_state(q_id).get_probability_one(q_id);
+	
+	QubitState* state = this->get_qubit(q_id)->get_state();
+	if (probability_one < epsilon) {
+		state->set_alpha(1);
+		state->set_beta(0);
+	} else if (probability_one > 1 - epsilon) {
+		state->set_alpha(0);
+		state->set_beta(1);
+	} else {
+		state->set_alpha(std::sqrt(1 - probability_one));
+		state->set_beta(std::sqrt(probability_one));
+	}
+}
+
 void CrossbarModel::add_qubit(int q_id, Qubit* qubit) {
 	this->qubits[q_id] = qubit;
 	QubitPosition* pos = qubit->get_position();
-	this->positions_qubits[pos->get_i()][pos->get_j()] = {q_id};
+	this->write_positions_qubits()[this->get_site(pos->get_i(), pos->get_j())] = {q_id};
+	this->board.set_occupied(pos->get_i(), pos->get_j(), true);
 	if (qubit->get_is_ancillary()) {
 		this->ancilla_qubits++;
 	} else {
@@ -524,11 +1010,21 @@ void CrossbarModel::add_qubit(int q_id, Qubit* qubit) {
 }
 
 void CrossbarModel::set_positions_qubits(int i, std::map<int, std::set<int> > q_map) {
-	this->positions_qubits[i] = q_map;
+	std::vector<std::set<int> >& positions_qubits = this->write_positions_qubits();
+	for (int j = 0; j < this->n; j++) {
+		auto it = q_map.find(j);
+		if (it != q_map.end()) {
+			positions_qubits[this->get_site(i, j)] = it->second;
+		} else {
+			positions_qubits[this->get_site(i, j)].clear();
+		}
+		this->board.set_occupied(i, j, !positions_qubits[this->get_site(i, j)].empty());
+	}
 }
 
 void CrossbarModel::set_positions_qubits(int i, int j, std::set<int> q_set) {
-	this->positions_qubits[i][j] = q_set;
+	this->write_positions_qubits()[this->get_site(i, j)] = q_set;
+	this->board.set_occupied(i, j, !q_set.empty());
 }
 
 Qubit* CrossbarModel::get_qubit(int q_id) {
@@ -541,23 +1037,35 @@ QubitPosition* CrossbarModel::get_position(int q_id) {
 	else return this->qubits[q_id]->get_position();
 }
 
-std::set<int> CrossbarModel::get_qubits(int i, int j) {
+const std::set<int>& CrossbarModel::get_qubits(int i, int j) {
 	// Validate params
-	if (this->positions_qubits.find(i) != this->positions_qubits.end()
-			&& this->positions_qubits[i].find(j) != this->positions_qubits[i].end()) {
-		return this->positions_qubits[i][j];
+	if (i >= 0 && i < this->m && j >= 0 && j < this->n) {
+		return (*this->positions_qubits)[this->get_site(i, j)];
 	} else {
-		std::cout << i << " " << j << std::endl << std::flush;
-		throw std::runtime_error("Invalid coordinates");
+		throw std::runtime_error("Invalid coordinates (" + std::to_string(i) + ", " + std::to_string(j) + ")");
 	}
 }
 
-std::set<int> CrossbarModel::get_qubits(int site) {
+const std::set<int>& CrossbarModel::get_qubits(int site) {
 	int j = site % this->n;
 	int i = (site - j) / this->n;
 	return this->get_qubits(i, j);
 }
 
+/**
+ * Check if a site holds any qubit (out of bounds sites are never occupied)
+ */
+bool CrossbarModel::is_occupied(int i, int j) {
+	if (i < 0 || i >= this->m || j < 0 || j >= this->n) {
+		return false;
+	}
+	return this->board.is_occupied(i, j);
+}
+
+const CrossbarBoard& CrossbarModel::get_board() {
+	return this->board;
+}
+
 int CrossbarModel::get_num_qubits() {
 	return this->qubits.size();
 }
@@ -628,7 +1136,7 @@ void CrossbarModel::inline_configuration() {
 	}
 }
 
-std::map<int, Qubit*> CrossbarModel::iter_qubits_positions() {
+const std::map<int, Qubit*>& CrossbarModel::iter_qubits_positions() {
 	return this->qubits;
 }
 
@@ -644,6 +1152,18 @@ void CrossbarModel::reset() {
  * @param num_qubits
  */
 void CrossbarModel::resize(int m, int n, int data_qubits, int ancilla_qubits) {
+	// The history is only valid for one size
+	this->stop_history();
+	std::string simulation_backend = this->get_simulation_backend();
+	this->quantum_state.reset();
+	this->measurements.clear();
+	this->sampled_qubits.clear();
+	this->sampled_flips.clear();
+	this->shuttled_qubits.clear();
+	this->errors.clear();
+	this->frames.reset();
+	this->stale_states.clear();
+	
 	// Create a square layout for the number of qubits
 	this->m = m;
 	this->n = n;
@@ -655,18 +1175,17 @@ void CrossbarModel::resize(int m, int n, int data_qubits, int ancilla_qubits) {
 	this->active_wave = 0;
 	
 	// Create horizontal, vertical & diagonal control lines;
-	this->h_lines.clear();
-	for (int i = 0; i <= this->m - 2; i++) this->h_lines[i] = new BarrierLine(0);
-	
-	this->v_lines.clear();
-	for (int j = 0; j <= this->n - 2; j++) this->v_lines[j] = new BarrierLine(0);
+	this->h_lines.assign(std::max(this->m - 1, 0), BarrierLine(0));
+	this->v_lines.assign(std::max(this->n - 1, 0), BarrierLine(0));
 	
 	this->d_lines.clear();
-	for (int k = -1 * (this->n - 1); k <= this->m; k++) this->d_lines[k] = new QubitLine(1.0 + abs(k) % 2);
+	this->d_lines.reserve(this->n + this->m);
+	for (int k = -1 * (this->n - 1); k <= this->m; k++) this->d_lines.push_back(QubitLine(1.0 + abs(k) % 2));
 	
 	// Create qubits & positions
-	this->positions_qubits.clear();
-	this->qubits.clear();
+	this->positions_qubits = std::make_shared<std::vector<std::set<int> > >(this->m * this->n);
+	this->board.resize(this->m, this->n);
+	this->release_qubits();
 	
 	// Position Placement
 	bool idle_configuration = (ceil((float) (this->m * this->n) / 2)) >= (data_qubits + ancilla_qubits);
@@ -680,11 +1199,332 @@ void CrossbarModel::resize(int m, int n, int data_qubits, int ancilla_qubits) {
 	}
 	
 	// Init constraints
-	this->init_constraints();
+	this->cycle_constraints = CycleConstraints(this->m, this->n);
+	this->solution.reset(this->m, this->n);
+	this->solution_cache->clear();
+	if (this->constraint_backend == NULL) {
+		this->constraint_backend = ConstraintBackend::create("auto");
+	}
+	
+	if (!simulation_backend.empty()) {
+		this->start_simulation(this->simulation_threads, simulation_backend);
+	}
 	
 	this->notify_resize_all();
 }
 
+/**
+ * Copy the state of a snapshot of this crossbar (same size and qubits)
+ * @param snapshot
+ */
+void CrossbarModel::restore(CrossbarModel* snapshot) {
+	// Only what differs from the snapshot is notified
+	if (this->active_wave != snapshot->active_wave) {
+		this->pending_changes.set_wave_changed();
+	}
+	for (size_t k = 0; k < this->h_lines.size() && k < snapshot->h_lines.size(); k++) {
+		if (this->h_lines[k].is_down() != snapshot->h_lines[k].is_down()) {
+			this->pending_changes.add_h_line(k);
+		}
+	}
+	for (size_t k = 0; k < this->v_lines.size() && k < snapshot->v_lines.size(); k++) {
+		if (this->v_lines[k].is_down() != snapshot->v_lines[k].is_down()) {
+			this->pending_changes.add_v_line(k);
+		}
+	}
+	for (size_t k = 0; k < this->d_lines.size() && k < snapshot->d_lines.size(); k++) {
+		if (this->d_lines[k].get_value() != snapshot->d_lines[k].get_value()) {
+			this->pending_changes.add_d_line((int) k - (this->n - 1));
+		}
+	}
+	for (auto const &entry : snapshot->qubits) {
+		auto it = this->qubits.find(entry.first);
+		QubitPosition* to = entry.second->get_position();
+		if (it == this->qubits.end()) {
+			this->pending_changes.add_qubit(entry.first);
+			continue;
+		}
+		QubitPosition* from = it->second->get_position();
+		if (from->get_i() != to->get_i() || from->get_j() != to->get_j()) {
+			this->pending_changes.add_move(entry.first,
+				this->get_site(from->get_i(), from->get_j()), this->get_site(to->get_i(), to->get_j()));
+		}
+	}
+	for (auto const &entry : snapshot->measurements) {
+		auto it = this->measurements.find(entry.first);
+		if (it == this->measurements.end() || it->second != entry.second) {
+			this->pending_changes.add_qubit(entry.first);
+		}
+	}
+	
+	this->active_wave = snapshot->active_wave;
+	this->h_lines = snapshot->h_lines;
+	this->v_lines = snapshot->v_lines;
+	this->d_lines = snapshot->d_lines;
+	this->positions_qubits = snapshot->positions_qubits;
+	this->board = snapshot->board;
+	this->quantum_state = snapshot->quantum_state;
+	this->simulation_threads = snapshot->simulation_threads;
+	this->stale_states = snapshot->stale_states;
+	this->measurements = snapshot->measurements;
+	this->random = snapshot->random;
+	this->sampling = snapshot->sampling;
+	this->sampled_qubits = snapshot->sampled_qubits;
+	this->sampled_flips = snapshot->sampled_flips;
+	this->timing = snapshot->timing;
+	this->noise = snapshot->noise;
+	this->shuttled_qubits = snapshot->shuttled_qubits;
+	this->errors = snapshot->errors;
+	this->frames = snapshot->frames;
+	this->state_version = snapshot->state_version;
+	
+	for (auto const &entry : snapshot->qubits) {
+		auto it = this->qubits.find(entry.first);
+		if (it != this->qubits.end()) {
+			*it->second = *entry.second;
+		} else {
+			this->qubits[entry.first] = new Qubit(*entry.second);
+		}
+	}
+	
+	this->notify_changes();
+}
+
+/**
+ * Check if another crossbar has the qubits in the same sites and the same
+ * control lines, wave and measurements (the quantum state is not compared)
+ * @param other
+ */
+bool CrossbarModel::has_same_configuration(CrossbarModel* other) {
+	if (this->active_wave != other->active_wave || this->measurements != other->measurements) {
+		return false;
+	}
+	if (this->positions_qubits != other->positions_qubits && *this->positions_qubits != *other->positions_qubits) {
+		return false;
+	}
+	if (this->h_lines.size() != other->h_lines.size() || this->v_lines.size() != other->v_lines.size()
+			|| this->d_lines.size() != other->d_lines.size()) {
+		return false;
+	}
+	for (size_t k = 0; k < this->h_lines.size(); k++) {
+		if (this->h_lines[k].is_down() != other->h_lines[k].is_down()) return false;
+	}
+	for (size_t k = 0; k < this->v_lines.size(); k++) {
+		if (this->v_lines[k].is_down() != other->v_lines[k].is_down()) return false;
+	}
+	for (size_t k = 0; k < this->d_lines.size(); k++) {
+		if (this->d_lines[k].get_value() != other->d_lines[k].get_value()) return false;
+	}
+	return true;
+}
+
+/**
+ * Record the changes of every cycle from now on
+ * @param checkpoint_interval cycles between full snapshots
+ * @param keep_states keep the register after every cycle that changes it,
+ * so that every cycle can be replayed; otherwise only the snapshots keep
+ * it and the cycles after them have to be executed again
+ */
+void CrossbarModel::start_history(int checkpoint_interval, bool keep_states) {
+	delete this->history;
+	this->history = new StateLog(checkpoint_interval, keep_states);
+	this->history->set_initial(this);
+	if (keep_states) {
+		this->history->add_state(this->quantum_state);
+	}
+	this->history_cycle = 0;
+	this->state_version = 0;
+	this->state_changed = false;
+}
+
+void CrossbarModel::stop_history() {
+	delete this->history;
+	this->history = NULL;
+	this->history_cycle = 0;
+}
+
+StateLog* CrossbarModel::get_history() {
+	return this->history;
+}
+
+int CrossbarModel::get_history_cycle() {
+	return this->history_cycle;
+}
+
+/**
+ * @return true if the recorded cycles can be undone and redone (always,
+ * unless the register is simulated and only kept in the snapshots)
+ */
+bool CrossbarModel::can_replay() {
+	return this->history != NULL
+		&& (this->quantum_state == nullptr || this->history->get_keep_states());
+}
+
+/**
+ * Close the changes of the current cycle
+ */
+void CrossbarModel::end_cycle() {
+	if (this->history == NULL) return;
+	
+	this->history->truncate(this->history_cycle);
+	if (this->state_changed && this->history->get_keep_states()) {
+		this->flush_gates();
+		int version = this->history->add_state(this->quantum_state);
+		this->record(StateDelta::STATE, 0, this->state_version, version);
+		this->state_version = version;
+	}
+	this->state_changed = false;
+	this->history->end_cycle(this);
+	this->history_cycle++;
+}
+
+/**
+ * Undo the last cycle
+ * @return false if there is nothing to undo
+ */
+bool CrossbarModel::step_back() {
+	if (!this->can_replay() || this->history_cycle == 0) return false;
+	
+	ChangeBatch batch(this);
+	this->history_cycle--;
+	auto begin = this->history->cycle_begin(this->history_cycle);
+	auto it = this->history->cycle_end(this->history_cycle);
+	while (it != begin) {
+		--it;
+		this->apply_delta(*it, false);
+	}
+	
+	return true;
+}
+
+/**
+ * Redo the next recorded cycle
+ * @return false if there is nothing to redo
+ */
+bool CrossbarModel::step_forward() {
+	if (!this->can_replay() || this->history_cycle >= this->history->get_num_cycles()) return false;
+	
+	ChangeBatch batch(this);
+	auto end = this->history->cycle_end(this->history_cycle);
+	for (auto it = this->history->cycle_begin(this->history_cycle); it != end; ++it) {
+		this->apply_delta(*it, true);
+	}
+	this->history_cycle++;
+	
+	return true;
+}
+
+/**
+ * Go to any recorded cycle. Far jumps start from the nearest checkpoint.
+ * When the cycles can not be replayed, it only goes back to the latest
+ * checkpoint before the cycle and the caller executes the rest.
+ * @param cycle
+ */
+void CrossbarModel::seek(int cycle) {
+	if (this->history == NULL) return;
+	cycle = std::max(0, std::min(cycle, this->history->get_num_cycles()));
+	
+	ChangeBatch batch(this);
+	int checkpoint_cycle;
+	CrossbarModel* checkpoint = this->history->get_checkpoint(cycle, checkpoint_cycle);
+	bool replay = this->can_replay();
+	if ((replay && std::abs(cycle - this->history_cycle) > cycle - checkpoint_cycle)
+			|| (!replay && (cycle < this->history_cycle || checkpoint_cycle > this->history_cycle))) {
+		this->restore(checkpoint);
+		this->history_cycle = checkpoint_cycle;
+	}
+	
+	while (this->history_cycle < cycle && this->step_forward());
+	while (this->history_cycle > cycle && this->step_back());
+}
+
+void CrossbarModel::record(int type, int index, double before, double after) {
+	if (this->history == NULL || this->replaying) return;
+	
+	// Changing the past starts a new branch
+	if (this->history_cycle < this->history->get_num_cycles()) {
+		this->history->truncate(this->history_cycle);
+	}
+	this->history->record({type, index, before, after});
+}
+
+/**
+ * Record the change of the one-qubit state of a qubit (kept by the
+ * history, the delta refers to the versions)
+ * @param q_id
+ * @param before state before the change
+ */
+void CrossbarModel::record_qubit_state(int q_id, const QubitState& before) {
+	if (this->history == NULL || this->replaying) return;
+	
+	this->history->truncate(this->history_cycle);
+	int before_version = this->history->add_qubit_state(before);
+	int after_version = this->history->add_qubit_state(*this->get_qubit(q_id)->get_state());
+	this->record(StateDelta::QUBIT_STATE, q_id, before_version, after_version);
+}
+
+void CrossbarModel::apply_delta(const StateDelta& delta, bool forward) {
+	double value = forward ? delta.after : delta.before;
+	
+	this->replaying = true;
+	switch (delta.type) {
+		case StateDelta::MOVE_QUBIT:
+			this->move_qubit(delta.index, (int) value / this->n, (int) value % this->n);
+			break;
+		case StateDelta::H_LINE:
+			this->h_lines.at(delta.index).set_state(value != 0 ? BarrierLine::LOWERED : BarrierLine::RAISED);
+			this->board.set_h_barrier_down(delta.index, value != 0);
+			this->pending_changes.add_h_line(delta.index);
+			break;
+		case StateDelta::V_LINE:
+			this->v_lines.at(delta.index).set_state(value != 0 ? BarrierLine::LOWERED : BarrierLine::RAISED);
+			this->board.set_v_barrier_down(delta.index, value != 0);
+			this->pending_changes.add_v_line(delta.index);
+			break;
+		case StateDelta::D_LINE:
+			this->get_d_line_ref(delta.index).set_value(value);
+			this->pending_changes.add_d_line(delta.index);
+			break;
+		case StateDelta::WAVE:
+			this->active_wave = (int) value;
+			this->pending_changes.set_wave_changed();
+			break;
+		case StateDelta::MEASURE:
+			if (value < 0) {
+				this->measurements.erase(delta.index);
+			} else {
+				this->measurements[delta.index] = (int) value;
+			}
+			this->pending_changes.add_qubit(delta.index);
+			break;
+		case StateDelta::ERROR:
+			if (value <= 0) {
+				this->errors.erase(delta.index);
+			} else {
+				this->errors[delta.index] = value;
+			}
+			this->pending_changes.add_qubit(delta.index);
+			break;
+		case StateDelta::QUBIT_STATE:
+			*this->get_qubit(delta.index)->get_state() = this->history->get_qubit_state((int) value);
+			this->pending_changes.add_qubit(delta.index);
+			break;
+		case StateDelta::STATE:
+			this->state_version = (int) value;
+			this->quantum_state = this->history->get_state(this->state_version);
+			if (this->quantum_state != nullptr) {
+				for (auto const &entry : this->qubits) {
+					this->stale_states.insert(entry.first);
+				}
+			}
+			for (auto const &entry : this->qubits) {
+				this->pending_changes.add_qubit(entry.first);
+			}
+			break;
+	}
+	this->replaying = false;
+}
+
 bool CrossbarModel::is_edge(int i) {
 	return this->is_top_edge(i) || this->is_bottom_edge(i);
 }
@@ -5,15 +5,30 @@
 #include <set>
 #include <vector>
 #include <tuple>
+#include <memory>
 #include <math.h>
+#include <string>
 #include <algorithm>
-#include <naxos.h>
 
 #include "control-lines/QubitLine.h"
 #include "control-lines/BarrierLine.h"
 #include "Qubit.h"
 #include "QubitState.h"
 #include "QubitPosition.h"
+#include "CrossbarBoard.h"
+#include "CrossbarSolution.h"
+#include "SolutionCache.h"
+#include "CycleConstraints.h"
+#include "StateLog.h"
+#include "ChangeSet.h"
+#include "DirtyRegion.h"
+#include "TimingTable.h"
+#include "simulation/StateVector.h"
+#include "simulation/QuantumBackend.h"
+#include "simulation/RandomGenerator.h"
+#include "simulation/NoiseModel.h"
+#include "simulation/PauliFrames.h"
+#include "solvers/ConstraintBackend.h"
 #include "crossbar/Subscriber.h"
 
 class CrossbarModel {
@@ -28,18 +43,14 @@ public:
 	CrossbarModel* clone();
 	
 	// CONSTRAINTS
-	void init_constraints();
 	void add_constraints();
-	naxos::NsProblemManager* get_problem_manager();
-	naxos::NsIntVar* get_h_line_constraint(int i);
-	naxos::NsIntVar* get_v_line_constraint(int i);
-	naxos::NsIntVar* get_d_line_constraint(int i);
-	std::map<int, std::map<int, naxos::NsIntVar*> > get_position_qubits_constraint();
-	naxos::NsIntVar* get_position_qubits_constraint(int i, int j);
-	naxos::NsIntVar* get_wave_constraint();
-	naxos::NsIntVar* get_wave_column_constraint();
-	void save_constraint_solution();
-	void restore_constraint_solution();
+	CycleConstraints* get_cycle_constraints();
+	ConstraintBackend* get_constraint_backend();
+	void set_constraint_backend(const std::string& name);
+	const CrossbarSolution& get_constraint_solution();
+	void set_constraint_solution(const CrossbarSolution& solution);
+	SolutionCache* get_solution_cache();
+	void share_solution_cache(CrossbarModel* model);
 	
 	int get_data_qubits();
 	int get_ancilla_qubits();
@@ -73,8 +84,52 @@ public:
 	
 	int get_active_wave();
 	
+	// Quantum state (shared register of all the qubits, only while simulating)
+	void start_simulation(int num_threads = 0, const std::string& backend = "statevector");
+	void stop_simulation();
+	bool is_simulating();
+	std::string get_simulation_backend();
+	const StateVector* get_state_vector();
+	double get_probability_one(int q_id);
+	QubitState* get_qubit_state(int q_id);
+	void flush_gates();
+	void apply_gate(const std::string& gate, int q_id, double angle = 0);
+	void apply_cz(int q_a, int q_b);
+	void apply_sqswap(int q_a, int q_b);
+	int measure(int q_id);
+	const std::map<int, int>& get_measurements();
+	void set_seed(uint64_t seed);
+	
+	// Shots (measurements only mark the qubits, sampled from the final state)
+	void set_sampling(bool enabled, int shots = 0);
+	const std::vector<int>& get_sampled_qubits();
+	std::map<std::string, int> sample(int shots, uint64_t seed = 0, int num_threads = 0);
+	
+	// Durations of the operations
+	void set_timing(const TimingTable& timing);
+	const TimingTable& get_timing();
+	
+	// Decoherence (errors of every cycle, probability of an error per qubit)
+	void set_noise_model(const NoiseModel& noise);
+	const NoiseModel& get_noise_model();
+	void apply_noise(int cycles = 1);
+	const std::map<int, double>& get_errors();
+	
 	void reset();
 	void resize(int m, int n, int data_qubits, int ancilla_qubits);
+	void restore(CrossbarModel* snapshot);
+	bool has_same_configuration(CrossbarModel* other);
+	
+	// History
+	void start_history(int checkpoint_interval = 1024, bool keep_states = false);
+	void stop_history();
+	StateLog* get_history();
+	int get_history_cycle();
+	bool can_replay();
+	void end_cycle();
+	bool step_back();
+	bool step_forward();
+	void seek(int cycle);
 	
 	void add_qubit(int q_id, Qubit* qubit);
 	void set_positions_qubits(int i, std::map<int, std::set<int> > q_map);
@@ -82,8 +137,10 @@ public:
 	
 	Qubit* get_qubit(int q_id);
 	QubitPosition* get_position(int q_id);
-	std::set<int> get_qubits(int i, int j);
-	std::set<int> get_qubits(int site);
+	const std::set<int>& get_qubits(int i, int j);
+	const std::set<int>& get_qubits(int site);
+	bool is_occupied(int i, int j);
+	const CrossbarBoard& get_board();
 	int get_num_qubits();
 
 	// Configurations
@@ -91,13 +148,18 @@ public:
 	void inline_configuration();
 	
 	// TODO: fix
-	std::map<int, Qubit*> iter_qubits_positions();
+	const std::map<int, Qubit*>& iter_qubits_positions();
 	
 	void subscribe(Subscriber* subscriber);
 	void unsubscribeAll();
 	void notify_all();
 	void notify_resize_all();
 	
+	// Deliver the changes made until the matching commit as one notification
+	void begin_changes();
+	void commit_changes();
+	DirtyRegion get_dirty_region(const ChangeSet& changes);
+	
 private:
 	// Original
 	CrossbarModel* original_model = NULL;
@@ -111,34 +173,88 @@ private:
 	// Wave (0: inactive, 1: odd, 2: even)
 	int active_wave;
 
-	// Control lines
-	std::map<int, BarrierLine*> h_lines;
-	std::map<int, BarrierLine*> v_lines;
-	std::map<int, QubitLine*> d_lines;
+	// Control lines (contiguous, QL[k] is stored at k + (n - 1))
+	std::vector<BarrierLine> h_lines;
+	std::vector<BarrierLine> v_lines;
+	std::vector<QubitLine> d_lines;
 
-	// Qubit positions
+	// Qubit positions (row-major, site (i, j) is stored at i * n + j).
+	// The site table is shared between clones until one writes to it.
 	std::map<int, Qubit*> qubits;
-	std::map<int, std::map<int, std::set<int>>> positions_qubits;
+	std::shared_ptr<std::vector<std::set<int> > > positions_qubits;
+	
+	// Bitset mirror of occupancy and lowered barriers
+	CrossbarBoard board;
+	
+	// Register of all the qubits, shared between clones until one applies
+	// a gate. Last outcome of every measured qubit.
+	std::shared_ptr<QuantumBackend> quantum_state;
+	int simulation_threads = 0;
+	std::map<int, int> measurements;
+	RandomGenerator random;
+	
+	// Measured qubits in sampling mode (in order of measurement) and
+	// the shots whose outcome is flipped by noise
+	bool sampling = false;
+	std::vector<int> sampled_qubits;
+	std::vector<std::vector<uint64_t> > sampled_flips;
+	
+	// Noise: qubits shuttled in the current cycle, accumulated error of
+	// every qubit and the errors of every shot (only when sampling)
+	TimingTable timing;
+	NoiseModel noise;
+	std::set<int> shuttled_qubits;
+	std::map<int, double> errors;
+	std::shared_ptr<PauliFrames> frames;
+	
+	// Qubits whose QubitState is behind the register
+	std::set<int> stale_states;
+	bool state_changed = false;
+	int state_version = 0;
 	
-	// Notification system
+	// Notification system (changes not delivered yet and open batches)
 	std::vector<Subscriber*> subscribers;
+	ChangeSet pending_changes;
+	int batch_depth = 0;
 	
-	// Variables for the constraints checker
-	naxos::NsProblemManager* pm = NULL;
-	std::map<int, naxos::NsIntVar*> h_lines_constraint;
-	std::map<int, naxos::NsIntVar*> v_lines_constraint;
-	std::map<int, naxos::NsIntVar*> d_lines_constraint;
-	std::map<int, std::map<int, naxos::NsIntVar*> > position_qubits_constraint;
-	naxos::NsIntVar* wave_constraint = NULL;
-	naxos::NsIntVar* wave_column_constraint = NULL;
+	// Constraints emitted by the operations in the current cycle
+	CycleConstraints cycle_constraints;
+	
+	// Deltas of every cycle (only while recording)
+	StateLog* history = NULL;
+	int history_cycle = 0;
+	bool replaying = false;
+	
+	// Solver of the constraints
+	ConstraintBackend* constraint_backend = NULL;
 	
 	// Store the latest solution
-	std::map<int, naxos::NsIntVar*> backup_h_lines_constraint;
-	std::map<int, naxos::NsIntVar*> backup_v_lines_constraint;
-	std::map<int, naxos::NsIntVar*> backup_d_lines_constraint;
-	std::map<int, std::map<int, naxos::NsIntVar*> > backup_position_qubits_constraint;
-	naxos::NsIntVar* backup_wave_constraint = NULL;
-	naxos::NsIntVar* backup_wave_column_constraint = NULL;
+	CrossbarSolution solution;
+	std::shared_ptr<SolutionCache> solution_cache = std::make_shared<SolutionCache>();
+	
+	CrossbarModel();
+	
+	std::vector<std::set<int> >& write_positions_qubits();
+	QuantumBackend& write_quantum_state();
+	QuantumBackend& read_quantum_state(int q_id = -1);
+	void sync_qubit_state(int q_id);
+	void check_not_sampled(int q_id);
+	PauliFrames& write_frames();
+	bool has_noise();
+	void notify_changes();
+	void shuttle_qubit(int q_id, int i_dest, int j_dest);
+	void record(int type, int index, double before, double after);
+	void record_qubit_state(int q_id, const QubitState& before);
+	void apply_delta(const StateDelta& delta, bool forward);
+	void release_qubits();
+	
+	int get_site(int i, int j) const {
+		return i * this->n + j;
+	}
+	
+	QubitLine& get_d_line_ref(int k) {
+		return this->d_lines.at(k + (this->n - 1));
+	}
 	
 	bool is_edge(int i);
 	bool is_top_edge(int i);
@@ -147,4 +263,23 @@ private:
 	bool contains(std::vector<int> list, int element);
 };
 
+/**
+ * Batch of the changes of a crossbar while it is in scope (also when an
+ * exception leaves it)
+ */
+class ChangeBatch {
+public:
+	ChangeBatch(CrossbarModel* model) {
+		this->model = model;
+		this->model->begin_changes();
+	}
+	
+	~ChangeBatch() {
+		this->model->commit_changes();
+	}
+	
+private:
+	CrossbarModel* model;
+};
+
 #endif //CROSSBAR_SIMULATOR_CROSSBARMODEL_H
@@ -0,0 +1,69 @@
+#include "CrossbarSolution.h"
+
+CrossbarSolution::CrossbarSolution() {
+	this->reset(0, 0);
+}
+
+/**
+ * Set every line to its lowest value (raised barriers and 0V QL lines)
+ * @param m
+ * @param n
+ */
+void CrossbarSolution::reset(int m, int n) {
+	this->m = m;
+	this->n = n;
+	this->h_lines.assign(m > 1 ? m - 1 : 0, 0);
+	this->v_lines.assign(n > 1 ? n - 1 : 0, 0);
+	this->d_lines.assign(m + n > 0 ? m + n : 0, 0);
+	this->wave = 0;
+	this->wave_column = 0;
+}
+
+int CrossbarSolution::get_h_line(int i) const {
+	return this->h_lines.at(i);
+}
+
+void CrossbarSolution::set_h_line(int i, int value) {
+	this->h_lines.at(i) = value;
+}
+
+int CrossbarSolution::get_v_line(int j) const {
+	return this->v_lines.at(j);
+}
+
+void CrossbarSolution::set_v_line(int j, int value) {
+	this->v_lines.at(j) = value;
+}
+
+int CrossbarSolution::get_d_line(int k) const {
+	return this->d_lines.at(k + (this->n - 1));
+}
+
+void CrossbarSolution::set_d_line(int k, int value) {
+	this->d_lines.at(k + (this->n - 1)) = value;
+}
+
+int CrossbarSolution::get_wave() const {
+	return this->wave;
+}
+
+void CrossbarSolution::set_wave(int wave) {
+	this->wave = wave;
+}
+
+int CrossbarSolution::get_wave_column() const {
+	return this->wave_column;
+}
+
+void CrossbarSolution::set_wave_column(int wave_column) {
+	this->wave_column = wave_column;
+}
+
+bool CrossbarSolution::operator==(const CrossbarSolution& other) const {
+	return this->m == other.m && this->n == other.n
+		&& this->h_lines == other.h_lines
+		&& this->v_lines == other.v_lines
+		&& this->d_lines == other.d_lines
+		&& this->wave == other.wave
+		&& this->wave_column == other.wave_column;
+}
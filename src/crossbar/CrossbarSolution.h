@@ -0,0 +1,44 @@
+#ifndef CROSSBAR_SIMULATOR_CROSSBARSOLUTION_H
+#define CROSSBAR_SIMULATOR_CROSSBARSOLUTION_H
+
+#include <vector>
+
+/**
+ * Values of the control lines chosen by the constraint checker for one cycle
+ */
+class CrossbarSolution {
+public:
+	CrossbarSolution();
+	
+	void reset(int m, int n);
+	
+	int get_h_line(int i) const;
+	void set_h_line(int i, int value);
+	
+	int get_v_line(int j) const;
+	void set_v_line(int j, int value);
+	
+	int get_d_line(int k) const;
+	void set_d_line(int k, int value);
+	
+	int get_wave() const;
+	void set_wave(int wave);
+	
+	int get_wave_column() const;
+	void set_wave_column(int wave_column);
+	
+	bool operator==(const CrossbarSolution& other) const;
+	
+private:
+	int m;
+	int n;
+	
+	// QL[k] is stored at k + (n - 1)
+	std::vector<int> h_lines;
+	std::vector<int> v_lines;
+	std::vector<int> d_lines;
+	int wave;
+	int wave_column;
+};
+
+#endif /* CROSSBAR_SIMULATOR_CROSSBARSOLUTION_H */
@@ -0,0 +1,136 @@
+#include "CycleConstraints.h"
+
+CycleConstraints::CycleConstraints(int m, int n) {
+	this->m = m;
+	this->n = n;
+}
+
+void CycleConstraints::clear() {
+	this->constraints.clear();
+}
+
+void CycleConstraints::fix_h_line(int i, int value) {
+	this->add(LineConstraint(LineConstraint::H_LINE, i, LineConstraint::EQUAL, value));
+}
+
+void CycleConstraints::fix_v_line(int j, int value) {
+	this->add(LineConstraint(LineConstraint::V_LINE, j, LineConstraint::EQUAL, value));
+}
+
+void CycleConstraints::fix_d_line(int k, int value) {
+	this->add(LineConstraint(LineConstraint::D_LINE, k, LineConstraint::EQUAL, value));
+}
+
+/**
+ * Reserve a site for a qubit
+ */
+void CycleConstraints::fix_site(int i, int j, int q_id) {
+	this->add(LineConstraint(LineConstraint::SITE, i * this->n + j, LineConstraint::EQUAL, q_id));
+}
+
+void CycleConstraints::fix_wave(int wave) {
+	this->add(LineConstraint(LineConstraint::WAVE, 0, LineConstraint::EQUAL, wave));
+}
+
+void CycleConstraints::fix_wave_column(int wave_column) {
+	this->add(LineConstraint(LineConstraint::WAVE_COLUMN, 0, LineConstraint::EQUAL, wave_column));
+}
+
+/**
+ * QL[k_a] (relation) QL[k_b]
+ */
+void CycleConstraints::compare_d_lines(int k_a, int relation, int k_b) {
+	this->add(LineConstraint(LineConstraint::D_LINE, k_a, relation, LineConstraint::D_LINE, k_b));
+}
+
+void CycleConstraints::add(const LineConstraint& constraint) {
+	this->constraints.push_back(constraint);
+}
+
+const std::vector<LineConstraint>& CycleConstraints::get_constraints() const {
+	return this->constraints;
+}
+
+bool CycleConstraints::empty() const {
+	return this->constraints.empty();
+}
+
+/**
+ * Dense id of a variable: RL, CL, QL, sites, wave and wave column
+ */
+int CycleConstraints::get_variable_id(int type, int index) const {
+	int h_count = this->m - 1;
+	int v_count = this->n - 1;
+	int d_count = this->m + this->n;
+	int site_count = this->m * this->n;
+	switch (type) {
+		case LineConstraint::H_LINE:
+			return index;
+		case LineConstraint::V_LINE:
+			return h_count + index;
+		case LineConstraint::D_LINE:
+			return h_count + v_count + index + (this->n - 1);
+		case LineConstraint::SITE:
+			return h_count + v_count + d_count + index;
+		case LineConstraint::WAVE:
+			return h_count + v_count + d_count + site_count;
+		default:
+			return h_count + v_count + d_count + site_count + 1;
+	}
+}
+
+int CycleConstraints::get_num_variables() const {
+	return this->get_variable_id(LineConstraint::WAVE_COLUMN, 0) + 1;
+}
+
+/**
+ * Split the constraints into groups that do not share any variable.
+ * Each group can be solved (and minimized) on its own.
+ * @return constraints of every connected component
+ */
+std::vector<std::vector<LineConstraint> > CycleConstraints::get_components() const {
+	std::unordered_map<int, int> parents;
+	
+	// Union of the variables of each constraint
+	for (const LineConstraint& constraint : this->constraints) {
+		int a = find(parents, this->get_variable_id(constraint.get_type(), constraint.get_index()));
+		if (constraint.is_binary()) {
+			int b = find(parents, this->get_variable_id(constraint.get_other_type(), constraint.get_other_index()));
+			if (a != b) parents[b] = a;
+		}
+	}
+	
+	// Group by root (in order of appearance)
+	std::unordered_map<int, int> component_ids;
+	std::vector<std::vector<LineConstraint> > components;
+	for (const LineConstraint& constraint : this->constraints) {
+		int root = find(parents, this->get_variable_id(constraint.get_type(), constraint.get_index()));
+		auto it = component_ids.find(root);
+		if (it == component_ids.end()) {
+			it = component_ids.insert(std::make_pair(root, (int) components.size())).first;
+			components.push_back({});
+		}
+		components[it->second].push_back(constraint);
+	}
+	
+	return components;
+}
+
+int CycleConstraints::find(std::unordered_map<int, int>& parents, int id) {
+	auto it = parents.find(id);
+	if (it == parents.end()) {
+		parents[id] = id;
+		return id;
+	}
+	int root = id;
+	while (parents[root] != root) {
+		root = parents[root];
+	}
+	// Path compression
+	while (parents[id] != root) {
+		int next = parents[id];
+		parents[id] = root;
+		id = next;
+	}
+	return root;
+}
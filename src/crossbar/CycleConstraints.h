@@ -0,0 +1,43 @@
+#ifndef CROSSBAR_SIMULATOR_CYCLECONSTRAINTS_H
+#define CROSSBAR_SIMULATOR_CYCLECONSTRAINTS_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "LineConstraint.h"
+
+/**
+ * Constraints emitted by the active operations during one cycle
+ */
+class CycleConstraints {
+public:
+	CycleConstraints(int m = 0, int n = 0);
+	
+	void clear();
+	
+	void fix_h_line(int i, int value);
+	void fix_v_line(int j, int value);
+	void fix_d_line(int k, int value);
+	void fix_site(int i, int j, int q_id);
+	void fix_wave(int wave);
+	void fix_wave_column(int wave_column);
+	void compare_d_lines(int k_a, int relation, int k_b);
+	
+	void add(const LineConstraint& constraint);
+	
+	const std::vector<LineConstraint>& get_constraints() const;
+	std::vector<std::vector<LineConstraint> > get_components() const;
+	
+	bool empty() const;
+	int get_variable_id(int type, int index) const;
+	int get_num_variables() const;
+	
+private:
+	int m;
+	int n;
+	std::vector<LineConstraint> constraints;
+	
+	static int find(std::unordered_map<int, int>& parents, int id);
+};
+
+#endif /* CROSSBAR_SIMULATOR_CYCLECONSTRAINTS_H */
@@ -0,0 +1,66 @@
+#include <algorithm>
+
+#include "DirtyRegion.h"
+
+DirtyRegion::DirtyRegion() {
+	
+}
+
+void DirtyRegion::add(int i0, int j0, int i1, int j1) {
+	Rect rect = {std::min(i0, i1), std::min(j0, j1), std::max(i0, i1), std::max(j0, j1)};
+	for (const Rect& other : this->rects) {
+		if (other.contains(rect)) return;
+	}
+	this->rects.erase(std::remove_if(this->rects.begin(), this->rects.end(),
+		[&rect](const Rect& other) { return rect.contains(other); }), this->rects.end());
+	this->rects.push_back(rect);
+	
+	if ((int) this->rects.size() > DirtyRegion::MAX_RECTS) {
+		Rect bounds = this->get_bounds();
+		this->rects = {bounds};
+	}
+}
+
+void DirtyRegion::add_site(int i, int j) {
+	this->add(i, j, i, j);
+}
+
+void DirtyRegion::clear() {
+	this->rects.clear();
+}
+
+bool DirtyRegion::empty() const {
+	return this->rects.empty();
+}
+
+bool DirtyRegion::intersects(int i0, int j0, int i1, int j1) const {
+	Rect rect = {std::min(i0, i1), std::min(j0, j1), std::max(i0, i1), std::max(j0, j1)};
+	for (const Rect& other : this->rects) {
+		if (other.intersects(rect)) return true;
+	}
+	
+	return false;
+}
+
+/**
+ * Smallest rectangle around all the others (i1 < i0 if empty)
+ */
+DirtyRegion::Rect DirtyRegion::get_bounds() const {
+	if (this->rects.empty()) {
+		return {0, 0, -1, -1};
+	}
+	
+	Rect bounds = this->rects.front();
+	for (const Rect& rect : this->rects) {
+		bounds.i0 = std::min(bounds.i0, rect.i0);
+		bounds.j0 = std::min(bounds.j0, rect.j0);
+		bounds.i1 = std::max(bounds.i1, rect.i1);
+		bounds.j1 = std::max(bounds.j1, rect.j1);
+	}
+	
+	return bounds;
+}
+
+const std::vector<DirtyRegion::Rect>& DirtyRegion::get_rects() const {
+	return this->rects;
+}
@@ -0,0 +1,45 @@
+#ifndef CROSSBAR_SIMULATOR_DIRTYREGION_H
+#define CROSSBAR_SIMULATOR_DIRTYREGION_H
+
+#include <vector>
+
+/**
+ * Sites of the crossbar that have to be redrawn, as rectangles of rows
+ * i0..i1 and columns j0..j1 (both inclusive). Rectangles inside another
+ * one are dropped and too many of them collapse into their bounds.
+ */
+class DirtyRegion {
+public:
+	struct Rect {
+		int i0;
+		int j0;
+		int i1;
+		int j1;
+		
+		bool contains(const Rect& other) const {
+			return this->i0 <= other.i0 && this->j0 <= other.j0 && other.i1 <= this->i1 && other.j1 <= this->j1;
+		}
+		
+		bool intersects(const Rect& other) const {
+			return this->i0 <= other.i1 && other.i0 <= this->i1 && this->j0 <= other.j1 && other.j0 <= this->j1;
+		}
+	};
+	
+	static const int MAX_RECTS = 64;
+	
+	DirtyRegion();
+	
+	void add(int i0, int j0, int i1, int j1);
+	void add_site(int i, int j);
+	void clear();
+	
+	bool empty() const;
+	bool intersects(int i0, int j0, int i1, int j1) const;
+	Rect get_bounds() const;
+	const std::vector<Rect>& get_rects() const;
+	
+private:
+	std::vector<Rect> rects;
+};
+
+#endif /* CROSSBAR_SIMULATOR_DIRTYREGION_H */
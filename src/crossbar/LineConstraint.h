@@ -0,0 +1,83 @@
+#ifndef CROSSBAR_SIMULATOR_LINECONSTRAINT_H
+#define CROSSBAR_SIMULATOR_LINECONSTRAINT_H
+
+/**
+ * A constraint over the control lines: "var (relation) value"
+ * or "var (relation) other var"
+ */
+class LineConstraint {
+public:
+	typedef enum {
+		H_LINE = 0,
+		V_LINE = 1,
+		D_LINE = 2,
+		SITE = 3,
+		WAVE = 4,
+		WAVE_COLUMN = 5
+	} VARIABLE;
+	
+	typedef enum {
+		EQUAL = 0,
+		LESS = 1,
+		GREATER = 2
+	} RELATION;
+	
+	LineConstraint(int type, int index, int relation, int value) {
+		this->type = type;
+		this->index = index;
+		this->relation = relation;
+		this->binary = false;
+		this->other_type = 0;
+		this->other_index = 0;
+		this->value = value;
+	}
+	
+	LineConstraint(int type, int index, int relation, int other_type, int other_index) {
+		this->type = type;
+		this->index = index;
+		this->relation = relation;
+		this->binary = true;
+		this->other_type = other_type;
+		this->other_index = other_index;
+		this->value = 0;
+	}
+	
+	int get_type() const {
+		return this->type;
+	}
+	
+	int get_index() const {
+		return this->index;
+	}
+	
+	int get_relation() const {
+		return this->relation;
+	}
+	
+	bool is_binary() const {
+		return this->binary;
+	}
+	
+	int get_other_type() const {
+		return this->other_type;
+	}
+	
+	int get_other_index() const {
+		return this->other_index;
+	}
+	
+	int get_value() const {
+		return this->value;
+	}
+	
+private:
+	int type;
+	int index;
+	int relation;
+	bool binary;
+	int other_type;
+	int other_index;
+	int value;
+};
+
+#endif /* CROSSBAR_SIMULATOR_LINECONSTRAINT_H */
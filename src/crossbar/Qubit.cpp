@@ -1,32 +1,50 @@
 #include "Qubit.h"
 
-Qubit::Qubit(QubitState* state, QubitPosition* position, bool is_ancillary) {
-	this->state = state;
-	this->position = position;
-	this->original_position = position;
+/**
+ * The qubit takes ownership of the state and position (their values are
+ * copied and the objects deleted)
+ */
+Qubit::Qubit(QubitState* state, QubitPosition* position, bool is_ancillary)
+	: state(*state), position(*position), original_position(*position) {
+	this->dephasing_time = 0;
 	this->is_ancillary = is_ancillary;
-}
-
-Qubit::~Qubit() {
 	delete state;
 	delete position;
-	delete original_position;
 }
 
-QubitState* Qubit::get_state() const {
-    return this->state;
+QubitState* Qubit::get_state() {
+    return &this->state;
 }
 
 void Qubit::set_state(QubitState* state) {
-    this->state = state;
+    this->state = *state;
+    delete state;
 }
 
-QubitPosition* Qubit::get_position() const {
-    return this->position;
+QubitPosition* Qubit::get_position() {
+    return &this->position;
 }
 
 void Qubit::set_position(QubitPosition* position) {
-    this->position = position;
+    this->position = *position;
+    delete position;
+}
+
+QubitPosition* Qubit::get_original_position() {
+	return &this->original_position;
+}
+
+void Qubit::set_original_position(QubitPosition* position) {
+	this->original_position = *position;
+	delete position;
+}
+
+double Qubit::get_dephasing_time() const {
+	return this->dephasing_time;
+}
+
+void Qubit::set_dephasing_time(double dephasing_time) {
+	this->dephasing_time = dephasing_time;
 }
 
 bool Qubit::get_is_ancillary() const {
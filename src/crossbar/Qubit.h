@@ -4,18 +4,21 @@
 #include "QubitState.h"
 #include "QubitPosition.h"
 
+/**
+ * The state and positions are stored inline, so copying a qubit is a
+ * single allocation
+ */
 class Qubit {
 public:
 	Qubit(QubitState* state, QubitPosition* position, bool is_ancillary);
-	~Qubit();
 	
-	QubitState* get_state() const;
+	QubitState* get_state();
 	void set_state(QubitState* state);
 
-	QubitPosition* get_position() const;
+	QubitPosition* get_position();
 	void set_position(QubitPosition* position);
 	
-	QubitPosition* get_original_position() const;
+	QubitPosition* get_original_position();
 	void set_original_position(QubitPosition* position);
 	
 	double get_dephasing_time() const;
@@ -25,9 +28,9 @@ public:
 	void set_is_ancillary(bool is_ancillary);
 	
 private:
-	QubitState* state;
-	QubitPosition* position;
-	QubitPosition* original_position;
+	QubitState state;
+	QubitPosition position;
+	QubitPosition original_position;
 	double dephasing_time;
 	bool is_ancillary;
 };
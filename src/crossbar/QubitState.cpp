@@ -13,33 +13,46 @@ std::complex<double> QubitState::get_beta() {
 	return this->beta;
 }
 
+void QubitState::set_alpha(std::complex<double> alpha) {
+	this->alpha = alpha;
+}
+
 void QubitState::set_beta(std::complex<double> beta) {
 	this->beta = beta;
 }
 
-void QubitState::rotate_phase() {
+void QubitState::apply(const GateMatrix& gate) {
+	std::complex<double> alpha = this->alpha;
+	this->alpha = gate.get(0, 0) * alpha + gate.get(0, 1) * this->beta;
+	this->beta = gate.get(1, 0) * alpha + gate.get(1, 1) * this->beta;
+}
 
+void QubitState::rotate_phase(double angle) {
+	this->beta *= std::polar(1.0, angle);
 }
 
 void QubitState::x_gate() {
-
+	this->apply(GateMatrix::from_name("x"));
 }
 
 void QubitState::z_gate() {
-
+	this->apply(GateMatrix::from_name("z"));
 }
 
 void QubitState::h_gate() {
-
+	this->apply(GateMatrix::from_name("h"));
 }
 
-int QubitState::measure() {
+/**
+ * Measure in the Z basis and collapse the state
+ * @param random uniform number in [0, 1)
+ * @return 0 or 1
+ */
+int QubitState::measure(double random) {
 	double zero_prob = std::pow(abs(this->alpha), 2);
-	// TODO: change random generator
-	double random_measure = (rand() / double(RAND_MAX));
 
 	// Collapse the state
-	if (random_measure <= zero_prob) {
+	if (random < zero_prob) {
 		this->alpha = 1;
 		this->beta  = 0;
 		return 0;
@@ -51,7 +64,11 @@ int QubitState::measure() {
 }
 
 void QubitState::normalize() {
-	
+	double norm = std::sqrt(std::norm(this->alpha) + std::norm(this->beta));
+	if (norm > 0) {
+		this->alpha /= norm;
+		this->beta /= norm;
+	}
 }
 
 void QubitState::reset() {
@@ -3,6 +3,8 @@
 
 #include <complex> 
 
+#include "simulation/GateMatrix.h"
+
 class QubitState {
 public:
 	
@@ -11,11 +13,12 @@ public:
 	std::complex<double> get_alpha();
 	std::complex<double> get_beta();
 	
+	void set_alpha(std::complex<double> alpha);
 	void set_beta(std::complex<double> beta);
 	
-	// TODO: finish implementation
+	void apply(const GateMatrix& gate);
 	
-	void rotate_phase();
+	void rotate_phase(double angle);
 	
 	void x_gate();
 	
@@ -23,7 +26,7 @@ public:
 	
 	void h_gate();
 	
-	int measure();
+	int measure(double random);
 	
 	void reset();
 	
@@ -36,4 +39,3 @@ private:
 };
 
 #endif /* QUBITSTATE_H */
-
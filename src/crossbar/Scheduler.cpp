@@ -0,0 +1,203 @@
+#include <typeinfo>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Scheduler.h"
+#include "ConstraintChecker.h"
+#include "operations/Wait.h"
+
+/**
+ * Replace the bundles of a program by its as soon as possible schedule.
+ * The waits of the program are deleted (the dependencies take their
+ * place) and the gaps of the schedule become new waits. The program is
+ * kept if it is not shortened.
+ * @param model initial crossbar (not modified)
+ * @param operations bundles of the program, rewritten in place
+ * @return cycles and bundles before and after
+ * @throws std::runtime_error if an operation can not be placed even
+ * after all the previous ones have finished
+ */
+ScheduleResult Scheduler::schedule(CrossbarModel* model, std::vector<std::vector<Operation*> >& operations) {
+	const TimingTable& timing = model->get_timing();
+	
+	ScheduleResult result;
+	result.cycles_before = Timeline(operations, timing).get_num_cycles();
+	result.bundles_before = get_num_bundles(operations);
+	result.cycles_after = result.cycles_before;
+	result.bundles_after = result.bundles_before;
+	
+	// The checker only needs the positions of the qubits
+	CrossbarModel* base_model = model->clone();
+	base_model->stop_simulation();
+	
+	// Crossbar before every cycle of the operations placed so far (and after the last one)
+	Timeline timeline;
+	std::vector<CrossbarModel*> states = {base_model};
+	std::string message;
+	if (!replay(states, timeline, 0, 0, message)) {
+		release(states);
+		throw std::runtime_error("Unable to schedule the program: " + message);
+	}
+	
+	std::vector<std::pair<int, Operation*> > issued;
+	std::vector<Operation*> waits;
+	
+	// First cycle after the last operation on each qubit (its last cycle
+	// is active too)
+	std::map<int, int> qubit_ready;
+	int last_end = 0;
+	
+	for (const std::vector<Operation*>& p_operations : operations) {
+		// Waits only pad the bundles written by hand
+		if (p_operations.size() == 1 && typeid(*p_operations.front()) == typeid(Wait)) {
+			waits.push_back(p_operations.front());
+			continue;
+		}
+		
+		for (Operation* operation : p_operations) {
+			int latency = operation->get_cycle_latency(timing);
+			int duration = operation->get_cycle_duration(timing);
+			// The qubits are found on the crossbar after the operations before it
+			std::vector<int> qubits = operation->get_dependent_qubits(states.back());
+			int start = 0;
+			for (int q_id : qubits) {
+				start = std::max(start, qubit_ready[q_id]);
+			}
+			
+			// Starting once everything before has finished is the sequential program
+			int issue = std::max(0, start - latency);
+			int last_issue = std::max(issue, last_end - latency);
+			while (true) {
+				Timeline candidate = timeline;
+				candidate.add_operation(issue, operation, timing);
+				if (replay(states, candidate, issue + latency, issue + latency + duration, message)) {
+					timeline = candidate;
+					break;
+				}
+				if (issue >= last_issue) {
+					release(states);
+					throw std::runtime_error("Unable to schedule the operation at line "
+						+ std::to_string(operation->get_line_number()) + ": " + message);
+				}
+				issue++;
+			}
+			issued.push_back({issue, operation});
+			
+			int end = issue + latency + duration + 1;
+			for (int q_id : qubits) {
+				qubit_ready[q_id] = end;
+			}
+			last_end = std::max(last_end, end);
+		}
+	}
+	release(states);
+	
+	if (timeline.get_num_cycles() >= result.cycles_before) {
+		return result;
+	}
+	
+	// One bundle per issue cycle (program order inside), waits in the gaps
+	std::stable_sort(issued.begin(), issued.end(),
+		[](const std::pair<int, Operation*>& a, const std::pair<int, Operation*>& b) { return a.first < b.first; });
+	std::vector<std::vector<Operation*> > scheduled;
+	int prev_issue = -1;
+	for (const std::pair<int, Operation*>& element : issued) {
+		if (element.first != prev_issue) {
+			if (element.first - prev_issue > 1) {
+				scheduled.push_back({new Wait(element.first - prev_issue - 1)});
+			}
+			scheduled.push_back({});
+			prev_issue = element.first;
+		}
+		scheduled.back().push_back(element.second);
+	}
+	
+	for (Operation* wait : waits) {
+		delete wait;
+	}
+	operations = scheduled;
+	
+	result.cycles_after = timeline.get_num_cycles();
+	result.bundles_after = get_num_bundles(operations);
+	
+	return result;
+}
+
+/**
+ * Check a timeline from a cycle on, starting from the crossbar kept
+ * before that cycle. Once the cycles changed by the timeline are over and
+ * the crossbar is as it was, the next cycles are the ones already checked.
+ * @param states crossbar before every cycle of the previous timeline,
+ * updated if the timeline is valid
+ * @param timeline
+ * @param first_cycle first cycle that differs from the previous timeline
+ * @param last_changed_cycle last cycle that differs from it
+ * @param message error of the constraint checker, if any
+ * @return true if the timeline is valid
+ */
+bool Scheduler::replay(std::vector<CrossbarModel*>& states, Timeline& timeline, int first_cycle,
+		int last_changed_cycle, std::string& message) {
+	first_cycle = std::min(first_cycle, (int) states.size() - 1);
+	int num_cycles = timeline.get_num_cycles();
+	
+	CrossbarModel* model = states[first_cycle]->clone();
+	model->share_solution_cache(states[first_cycle]);
+	std::vector<CrossbarModel*> replayed;
+	int converged_cycle = -1;
+	try {
+		for (int curr_cycle = first_cycle; curr_cycle < num_cycles; curr_cycle++) {
+			ConstraintChecker::validate_cycle(model, timeline.get_active(curr_cycle), curr_cycle);
+			
+			if (curr_cycle >= last_changed_cycle && curr_cycle + 1 < (int) states.size()
+					&& model->has_same_configuration(states[curr_cycle + 1])) {
+				converged_cycle = curr_cycle + 1;
+				break;
+			}
+			CrossbarModel* state = model->clone();
+			state->share_solution_cache(model);
+			replayed.push_back(state);
+		}
+	} catch (const std::exception& ex) {
+		message = ex.what();
+		delete model;
+		release(replayed);
+		return false;
+	}
+	delete model;
+	
+	// Keep the states up to the first cycle and from the convergence on
+	std::vector<CrossbarModel*> tail;
+	if (converged_cycle != -1) {
+		tail.assign(states.begin() + converged_cycle, states.end());
+		states.erase(states.begin() + converged_cycle, states.end());
+	}
+	while ((int) states.size() > first_cycle + 1) {
+		delete states.back();
+		states.pop_back();
+	}
+	states.insert(states.end(), replayed.begin(), replayed.end());
+	states.insert(states.end(), tail.begin(), tail.end());
+	
+	return true;
+}
+
+void Scheduler::release(std::vector<CrossbarModel*>& states) {
+	for (CrossbarModel* state : states) {
+		delete state;
+	}
+	states.clear();
+}
+
+/**
+ * Bundles that are not waits
+ */
+int Scheduler::get_num_bundles(const std::vector<std::vector<Operation*> >& operations) {
+	int num_bundles = 0;
+	for (const std::vector<Operation*>& p_operations : operations) {
+		if (!(p_operations.size() == 1 && typeid(*p_operations.front()) == typeid(Wait))) {
+			num_bundles++;
+		}
+	}
+	
+	return num_bundles;
+}
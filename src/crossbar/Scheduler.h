@@ -0,0 +1,48 @@
+#ifndef CROSSBAR_SIMULATOR_SCHEDULER_H
+#define CROSSBAR_SIMULATOR_SCHEDULER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CrossbarModel.h"
+#include "Timeline.h"
+#include "operations/Operation.h"
+
+/**
+ * Total cycles (and bundles) of a program before and after scheduling
+ */
+struct ScheduleResult {
+	int cycles_before;
+	int cycles_after;
+	int bundles_before;
+	int bundles_after;
+};
+
+/**
+ * As soon as possible list scheduler. The program is taken as a sequence
+ * (the bundles in order, without its waits) and every operation is
+ * issued at the first cycle where:
+ *  - the operations before it on any of its qubits (and on the ancilla
+ *    a measurement reads through) have finished and
+ *  - the constraint checker accepts the program scheduled so far, which
+ *    covers the conflicts on the shared RL/CL/QL lines (they depend on
+ *    where the qubits are at that cycle, so they are not known upfront).
+ * The crossbar before every cycle of the schedule is kept, so a candidate
+ * is only checked from its first cycle until the crossbar is again as it
+ * was without it, and all the copies share one solution cache.
+ */
+class Scheduler {
+public:
+	static ScheduleResult schedule(CrossbarModel* model, std::vector<std::vector<Operation*> >& operations);
+	
+private:
+	static bool replay(std::vector<CrossbarModel*>& states, Timeline& timeline, int first_cycle,
+		int last_changed_cycle, std::string& message);
+	
+	static void release(std::vector<CrossbarModel*>& states);
+	
+	static int get_num_bundles(const std::vector<std::vector<Operation*> >& operations);
+};
+
+#endif /* CROSSBAR_SIMULATOR_SCHEDULER_H */
@@ -0,0 +1,65 @@
+#include "SolutionCache.h"
+
+SolutionCache::SolutionCache(size_t max_entries) {
+	this->max_entries = max_entries;
+	this->hits = 0;
+	this->misses = 0;
+}
+
+/**
+ * Look for a stored solution
+ * @param key signature of the cycle
+ * @param solution output, only written on a hit
+ * @return true on a hit
+ */
+bool SolutionCache::find(const std::vector<uint64_t>& key, CrossbarSolution& solution) {
+	auto it = this->entries.find(key);
+	if (it == this->entries.end()) {
+		this->misses++;
+		return false;
+	}
+	
+	this->hits++;
+	solution = it->second;
+	return true;
+}
+
+/**
+ * Store a solution. The cache is flushed when it reaches its maximum size.
+ */
+void SolutionCache::insert(const std::vector<uint64_t>& key, const CrossbarSolution& solution) {
+	if (this->entries.size() >= this->max_entries) {
+		this->entries.clear();
+	}
+	this->entries[key] = solution;
+}
+
+void SolutionCache::clear() {
+	this->entries.clear();
+	this->hits = 0;
+	this->misses = 0;
+}
+
+size_t SolutionCache::get_size() const {
+	return this->entries.size();
+}
+
+long SolutionCache::get_hits() const {
+	return this->hits;
+}
+
+long SolutionCache::get_misses() const {
+	return this->misses;
+}
+
+/**
+ * FNV-1a over the words of the key
+ */
+size_t SolutionCache::KeyHash::operator()(const std::vector<uint64_t>& key) const {
+	uint64_t hash = 14695981039346656037ULL;
+	for (uint64_t word : key) {
+		hash ^= word;
+		hash *= 1099511628211ULL;
+	}
+	return (size_t) hash;
+}
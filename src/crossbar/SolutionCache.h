@@ -0,0 +1,37 @@
+#ifndef CROSSBAR_SIMULATOR_SOLUTIONCACHE_H
+#define CROSSBAR_SIMULATOR_SOLUTIONCACHE_H
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+
+#include "CrossbarSolution.h"
+
+/**
+ * Memoization of the constraint solutions by cycle signature
+ */
+class SolutionCache {
+public:
+	SolutionCache(size_t max_entries = 4096);
+	
+	bool find(const std::vector<uint64_t>& key, CrossbarSolution& solution);
+	void insert(const std::vector<uint64_t>& key, const CrossbarSolution& solution);
+	void clear();
+	
+	size_t get_size() const;
+	long get_hits() const;
+	long get_misses() const;
+	
+private:
+	struct KeyHash {
+		size_t operator()(const std::vector<uint64_t>& key) const;
+	};
+	
+	size_t max_entries;
+	long hits;
+	long misses;
+	std::unordered_map<std::vector<uint64_t>, CrossbarSolution, KeyHash> entries;
+};
+
+#endif /* CROSSBAR_SIMULATOR_SOLUTIONCACHE_H */
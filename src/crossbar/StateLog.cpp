@@ -0,0 +1,151 @@
+#include <algorithm>
+
+#include "StateLog.h"
+#include "CrossbarModel.h"
+#include "simulation/QuantumBackend.h"
+
+StateLog::StateLog(int checkpoint_interval, bool keep_states) {
+	this->checkpoint_interval = checkpoint_interval;
+	this->keep_states = keep_states;
+	this->cycle_starts = {0};
+}
+
+StateLog::~StateLog() {
+	this->clear();
+}
+
+void StateLog::record(const StateDelta& delta) {
+	this->deltas.push_back(delta);
+}
+
+/**
+ * Close the deltas of the current cycle
+ * @param model crossbar after the cycle (for checkpoints)
+ */
+void StateLog::end_cycle(CrossbarModel* model) {
+	this->cycle_starts.push_back(this->deltas.size());
+	
+	int num_cycles = this->get_num_cycles();
+	if (num_cycles % this->checkpoint_interval == 0
+			&& (int) this->checkpoints.size() == num_cycles / this->checkpoint_interval) {
+		this->checkpoints.push_back(model->clone());
+	}
+}
+
+/**
+ * Forget the cycles after the given one (a new branch of the history)
+ */
+void StateLog::truncate(int num_cycles) {
+	if (num_cycles >= this->get_num_cycles()) return;
+	
+	this->deltas.resize(this->cycle_starts[num_cycles]);
+	this->cycle_starts.resize(num_cycles + 1);
+	
+	size_t num_checkpoints = num_cycles / this->checkpoint_interval + 1;
+	while (this->checkpoints.size() > num_checkpoints) {
+		delete this->checkpoints.back();
+		this->checkpoints.pop_back();
+	}
+	
+	size_t num_states = 1;
+	for (const StateDelta& delta : this->deltas) {
+		if (delta.type == StateDelta::STATE) {
+			num_states = std::max(num_states, (size_t) delta.after + 1);
+		}
+	}
+	if (this->states.size() > num_states) {
+		this->states.resize(num_states);
+	}
+	
+	size_t num_qubit_states = 0;
+	for (const StateDelta& delta : this->deltas) {
+		if (delta.type == StateDelta::QUBIT_STATE) {
+			num_qubit_states = std::max(num_qubit_states, (size_t) std::max(delta.before, delta.after) + 1);
+		}
+	}
+	if (this->qubit_states.size() > num_qubit_states) {
+		this->qubit_states.erase(this->qubit_states.begin() + num_qubit_states, this->qubit_states.end());
+	}
+}
+
+void StateLog::clear() {
+	for (CrossbarModel* checkpoint : this->checkpoints) {
+		delete checkpoint;
+	}
+	this->checkpoints.clear();
+	this->states.clear();
+	this->qubit_states.clear();
+	this->deltas.clear();
+	this->cycle_starts = {0};
+}
+
+int StateLog::get_num_cycles() const {
+	return this->cycle_starts.size() - 1;
+}
+
+int StateLog::get_checkpoint_interval() const {
+	return this->checkpoint_interval;
+}
+
+/**
+ * @return true if a version of the register is kept after every cycle
+ * that changed it, false if it is only in the snapshots
+ */
+bool StateLog::get_keep_states() const {
+	return this->keep_states;
+}
+
+std::vector<StateDelta>::const_iterator StateLog::cycle_begin(int cycle) const {
+	return this->deltas.begin() + this->cycle_starts.at(cycle);
+}
+
+std::vector<StateDelta>::const_iterator StateLog::cycle_end(int cycle) const {
+	return this->deltas.begin() + this->cycle_starts.at(cycle + 1);
+}
+
+/**
+ * Start a new history from the given crossbar
+ */
+void StateLog::set_initial(CrossbarModel* model) {
+	this->clear();
+	this->checkpoints.push_back(model->clone());
+}
+
+/**
+ * Get the latest snapshot taken before the given cycle
+ * @param cycle
+ * @param checkpoint_cycle cycle of the snapshot
+ * @return snapshot (owned by the log)
+ */
+CrossbarModel* StateLog::get_checkpoint(int cycle, int& checkpoint_cycle) const {
+	int k = std::min(cycle / this->checkpoint_interval, (int) this->checkpoints.size() - 1);
+	checkpoint_cycle = k * this->checkpoint_interval;
+	return this->checkpoints[k];
+}
+
+/**
+ * Keep a version of the quantum state (shared with the crossbar until
+ * it applies the next gate)
+ * @return version
+ */
+int StateLog::add_state(std::shared_ptr<QuantumBackend> state) {
+	this->states.push_back(state);
+	return this->states.size() - 1;
+}
+
+std::shared_ptr<QuantumBackend> StateLog::get_state(int version) const {
+	return this->states.at(version);
+}
+
+/**
+ * Keep a copy of the state of one qubit
+ * @return version
+ */
+int StateLog::add_qubit_state(const QubitState& state) {
+	this->qubit_states.push_back(state);
+	return this->qubit_states.size() - 1;
+}
+
+const QubitState& StateLog::get_qubit_state(int version) const {
+	return this->qubit_states.at(version);
+}
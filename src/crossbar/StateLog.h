@@ -0,0 +1,87 @@
+#ifndef CROSSBAR_SIMULATOR_STATELOG_H
+#define CROSSBAR_SIMULATOR_STATELOG_H
+
+#include <vector>
+#include <memory>
+
+#include "QubitState.h"
+
+/**
+ * A change of the crossbar: a qubit move (sites), a barrier toggle,
+ * a QL voltage, the wave, a measurement outcome (-1: not measured),
+ * the version of the quantum state, the accumulated error of a qubit or
+ * the version of the one-qubit state of a qubit (without simulation)
+ */
+struct StateDelta {
+	typedef enum {
+		MOVE_QUBIT = 0,
+		H_LINE = 1,
+		V_LINE = 2,
+		D_LINE = 3,
+		WAVE = 4,
+		MEASURE = 5,
+		STATE = 6,
+		ERROR = 7,
+		QUBIT_STATE = 8
+	} TYPE;
+	
+	int type;
+	int index;
+	double before;
+	double after;
+};
+
+class CrossbarModel;
+class QuantumBackend;
+
+/**
+ * Append-only log of the changes of each cycle, with a full snapshot
+ * of the crossbar every few cycles. The quantum register is either kept
+ * after every cycle that changed it or only in the snapshots.
+ */
+class StateLog {
+public:
+	StateLog(int checkpoint_interval = 1024, bool keep_states = true);
+	~StateLog();
+	
+	void record(const StateDelta& delta);
+	void end_cycle(CrossbarModel* model);
+	void truncate(int num_cycles);
+	void clear();
+	
+	int get_num_cycles() const;
+	int get_checkpoint_interval() const;
+	bool get_keep_states() const;
+	std::vector<StateDelta>::const_iterator cycle_begin(int cycle) const;
+	std::vector<StateDelta>::const_iterator cycle_end(int cycle) const;
+	
+	void set_initial(CrossbarModel* model);
+	CrossbarModel* get_checkpoint(int cycle, int& checkpoint_cycle) const;
+	
+	int add_state(std::shared_ptr<QuantumBackend> state);
+	std::shared_ptr<QuantumBackend> get_state(int version) const;
+	
+	int add_qubit_state(const QubitState& state);
+	const QubitState& get_qubit_state(int version) const;
+	
+private:
+	int checkpoint_interval;
+	bool keep_states;
+	
+	// Deltas of cycle c are in [cycle_starts[c], cycle_starts[c + 1])
+	std::vector<StateDelta> deltas;
+	std::vector<size_t> cycle_starts;
+	
+	// Snapshot of the crossbar before cycle k * checkpoint_interval
+	std::vector<CrossbarModel*> checkpoints;
+	
+	// Quantum state after every cycle that changed it (STATE deltas
+	// refer to these versions)
+	std::vector<std::shared_ptr<QuantumBackend> > states;
+	
+	// One-qubit states before and after the changes without simulation
+	// (QUBIT_STATE deltas refer to these versions)
+	std::vector<QubitState> qubit_states;
+};
+
+#endif /* CROSSBAR_SIMULATOR_STATELOG_H */
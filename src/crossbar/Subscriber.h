@@ -1,12 +1,21 @@
 #ifndef SUBSCRIBER_H
 #define SUBSCRIBER_H
 
+#include "crossbar/ChangeSet.h"
+
 class Subscriber {
 
 public:
 	
 	virtual void notified() = 0;
 	
+	// Once per batch of changes, with the lines, qubits and moves that
+	// changed (CrossbarModel::get_dirty_region gives the sites they touch).
+	// By default, as if anything changed.
+	virtual void notified_changes(const ChangeSet& changes) {
+		this->notified();
+	}
+	
 	virtual void notified_resize() = 0;
 	
 };
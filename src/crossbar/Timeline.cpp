@@ -0,0 +1,99 @@
+#include <typeinfo>
+#include <algorithm>
+
+#include "Timeline.h"
+#include "operations/Wait.h"
+
+Timeline::Timeline() {
+	this->num_cycles = 1;
+	this->curr_cycle = -1;
+	this->next_entry = 0;
+}
+
+/**
+ * Place the parallel operations one cycle after the other; a wait
+ * moves the next ones by its duration.
+ * @param operations
+ * @param timing latency and duration of every operation
+ */
+Timeline::Timeline(const std::vector<std::vector<Operation*> >& operations, const TimingTable& timing) : Timeline() {
+	int curr_cycle = 0;
+	for (const std::vector<Operation*>& p_operations : operations) {
+		// Check if wait operation
+		if (p_operations.size() == 1 && typeid(*p_operations.front()) == typeid(Wait)) {
+			Wait* wait_op = dynamic_cast<Wait*>(p_operations.front());
+			curr_cycle += wait_op->get_cycle_duration(timing);
+			continue;
+		}
+		
+		for (Operation* operation : p_operations) {
+			int start = curr_cycle + operation->get_cycle_latency(timing);
+			this->entries.push_back({start, start + operation->get_cycle_duration(timing), operation});
+			this->num_cycles = std::max(this->num_cycles, this->entries.back().high + 1);
+		}
+		
+		curr_cycle++;
+	}
+	
+	// Latencies can start an operation after a later one (same start: program order)
+	std::stable_sort(this->entries.begin(), this->entries.end(),
+		[](const Entry& a, const Entry& b) { return a.low < b.low; });
+}
+
+/**
+ * Insert an operation keeping the entries sorted; it goes after the
+ * operations with the same start, as if it came later in the program.
+ * Rewinds the cursor of get_active.
+ * @param issue_cycle cycle of its bundle (the latency is added)
+ * @param operation
+ * @param timing
+ */
+void Timeline::add_operation(int issue_cycle, Operation* operation, const TimingTable& timing) {
+	int start = issue_cycle + operation->get_cycle_latency(timing);
+	Entry entry = {start, start + operation->get_cycle_duration(timing), operation};
+	auto it = std::upper_bound(this->entries.begin(), this->entries.end(), start,
+		[](int value, const Entry& other) { return value < other.low; });
+	this->entries.insert(it, entry);
+	this->num_cycles = std::max(this->num_cycles, entry.high + 1);
+	
+	this->curr_cycle = -1;
+	this->next_entry = 0;
+	this->active.clear();
+}
+
+int Timeline::get_num_cycles() const {
+	return this->num_cycles;
+}
+
+const std::vector<Timeline::Entry>& Timeline::get_entries() const {
+	return this->entries;
+}
+
+/**
+ * Operations with low <= cycle <= high. Asking for the next cycle only
+ * updates the operations that start or end; any other cycle starts
+ * from the beginning.
+ * @param cycle
+ */
+const std::vector<Timeline::Entry>& Timeline::get_active(int cycle) {
+	if (cycle < this->curr_cycle) {
+		this->active.clear();
+		this->next_entry = 0;
+	}
+	this->curr_cycle = cycle;
+	
+	// The entries are sorted by start, so the new ones go at the end
+	while (this->next_entry < this->entries.size() && this->entries[this->next_entry].low <= cycle) {
+		this->active.push_back(this->entries[this->next_entry++]);
+	}
+	this->active.erase(std::remove_if(this->active.begin(), this->active.end(),
+		[cycle](const Entry& entry) { return entry.high < cycle; }), this->active.end());
+	
+	return this->active;
+}
+
+int Timeline::get_next_start(int cycle) const {
+	auto it = std::lower_bound(this->entries.begin(), this->entries.end(), cycle,
+		[](const Entry& entry, int value) { return entry.low < value; });
+	return (it != this->entries.end()) ? it->low : this->num_cycles;
+}
@@ -0,0 +1,46 @@
+#ifndef CROSSBAR_SIMULATOR_TIMELINE_H
+#define CROSSBAR_SIMULATOR_TIMELINE_H
+
+#include <vector>
+#include <interval-tree.h>
+
+#include "TimingTable.h"
+#include "operations/Operation.h"
+
+/**
+ * Cycles of the operations of a program, sorted once by their start.
+ * The operations of consecutive cycles are found by adding the ones that
+ * start and dropping the ones that ended, and the cycles without any
+ * operation (waits) can be jumped over.
+ */
+class Timeline {
+public:
+	typedef Intervals::Interval<int, Operation*> Entry;
+	
+	Timeline();
+	Timeline(const std::vector<std::vector<Operation*> >& operations, const TimingTable& timing = TimingTable());
+	
+	// Place one more operation issued at a cycle (after the ones starting with it)
+	void add_operation(int issue_cycle, Operation* operation, const TimingTable& timing = TimingTable());
+	
+	int get_num_cycles() const;
+	const std::vector<Entry>& get_entries() const;
+	
+	// Operations executing in a cycle (by start, then program order)
+	const std::vector<Entry>& get_active(int cycle);
+	
+	// First cycle from cycle on where an operation starts (or the end)
+	int get_next_start(int cycle) const;
+	
+private:
+	// Sorted by start cycle
+	std::vector<Entry> entries;
+	int num_cycles;
+	
+	// Cursor of get_active
+	int curr_cycle;
+	size_t next_entry;
+	std::vector<Entry> active;
+};
+
+#endif /* CROSSBAR_SIMULATOR_TIMELINE_H */
@@ -0,0 +1,95 @@
+#include <math.h>
+#include <stdexcept>
+
+#include "TimingTable.h"
+
+static const char* KIND_NAMES[TimingTable::NUM_KINDS] = {
+	"shuttle", "shuttle_gate", "single_gate", "cphase", "sqswap", "measurement"
+};
+
+// Durations of the hardware (ns)
+static const double DEFAULT_DURATIONS[TimingTable::NUM_KINDS] = {20, 20, 40, 80, 80, 80};
+
+// Last relative cycle in which each operation acts on the crossbar
+static const int MIN_CYCLES[TimingTable::NUM_KINDS] = {2, 2, 4, 2, 8, 8};
+
+TimingTable::TimingTable() {
+	this->cycle_time = 10;
+	for (int kind = 0; kind < NUM_KINDS; kind++) {
+		this->durations[kind] = DEFAULT_DURATIONS[kind];
+		this->latencies[kind] = 0;
+	}
+	this->compile();
+}
+
+double TimingTable::get_cycle_time() const {
+	return this->cycle_time;
+}
+
+void TimingTable::set_cycle_time(double cycle_time) {
+	if (cycle_time <= 0) {
+		throw std::runtime_error("Invalid cycle time " + std::to_string(cycle_time));
+	}
+	this->cycle_time = cycle_time;
+	this->compile();
+}
+
+double TimingTable::get_duration(int kind) const {
+	return this->durations[kind];
+}
+
+void TimingTable::set_duration(int kind, double duration) {
+	this->durations[kind] = duration;
+	this->compile();
+}
+
+double TimingTable::get_latency(int kind) const {
+	return this->latencies[kind];
+}
+
+void TimingTable::set_latency(int kind, double latency) {
+	this->latencies[kind] = latency;
+	this->compile();
+}
+
+/**
+ * Check that every operation lasts the cycles its steps need
+ * @throws std::runtime_error otherwise
+ */
+void TimingTable::check() const {
+	for (int kind = 0; kind < NUM_KINDS; kind++) {
+		if (this->cycles[kind] < MIN_CYCLES[kind]) {
+			throw std::runtime_error("The " + TimingTable::get_name(kind) + " needs at least "
+				+ std::to_string(MIN_CYCLES[kind]) + " cycles, but lasts " + std::to_string(this->cycles[kind]));
+		}
+		if (this->latency_cycles[kind] < 0) {
+			throw std::runtime_error("Negative latency of the " + TimingTable::get_name(kind));
+		}
+	}
+}
+
+/**
+ * @param name "shuttle", "shuttle_gate", "single_gate", "cphase", "sqswap" or "measurement"
+ * @throws std::runtime_error if the name is unknown
+ */
+int TimingTable::get_kind(const std::string& name) {
+	for (int kind = 0; kind < NUM_KINDS; kind++) {
+		if (name == KIND_NAMES[kind]) return kind;
+	}
+	throw std::runtime_error("Unknown operation " + name + " in the timing");
+}
+
+std::string TimingTable::get_name(int kind) {
+	return KIND_NAMES[kind];
+}
+
+/**
+ * Whole cycles of every duration and latency (the same truncation as
+ * the hard-coded durations had)
+ */
+void TimingTable::compile() {
+	for (int kind = 0; kind < NUM_KINDS; kind++) {
+		this->cycles[kind] = (int) floor(this->durations[kind] / this->cycle_time + 1e-9);
+		this->latency_cycles[kind] = (int) floor(this->latencies[kind] / this->cycle_time + 1e-9);
+	}
+}
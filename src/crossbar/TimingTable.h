@@ -0,0 +1,59 @@
+#ifndef CROSSBAR_SIMULATOR_TIMINGTABLE_H
+#define CROSSBAR_SIMULATOR_TIMINGTABLE_H
+
+#include <string>
+
+/**
+ * Cycle time and the latency and duration of every kind of operation
+ * (in ns). The values are compiled into cycles when set, so the
+ * timeline looks them up by kind without any conversion.
+ */
+class TimingTable {
+public:
+	typedef enum {
+		SHUTTLE = 0,
+		SHUTTLE_GATE = 1,
+		SINGLE_GATE = 2,
+		CPHASE = 3,
+		SQSWAP = 4,
+		MEASUREMENT = 5
+	} KIND;
+	
+	static const int NUM_KINDS = 6;
+	
+	TimingTable();
+	
+	double get_cycle_time() const;
+	void set_cycle_time(double cycle_time);
+	
+	double get_duration(int kind) const;
+	void set_duration(int kind, double duration);
+	double get_latency(int kind) const;
+	void set_latency(int kind, double latency);
+	
+	// Compiled values
+	int get_cycles(int kind) const {
+		return this->cycles[kind];
+	}
+	
+	int get_latency_cycles(int kind) const {
+		return this->latency_cycles[kind];
+	}
+	
+	void check() const;
+	
+	static int get_kind(const std::string& name);
+	static std::string get_name(int kind);
+	
+private:
+	double cycle_time;
+	double durations[NUM_KINDS];
+	double latencies[NUM_KINDS];
+	
+	int cycles[NUM_KINDS];
+	int latency_cycles[NUM_KINDS];
+	
+	void compile();
+};
+
+#endif /* CROSSBAR_SIMULATOR_TIMINGTABLE_H */
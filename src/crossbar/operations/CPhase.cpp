@@ -1,6 +1,6 @@
 #include "CPhase.h"
 
-CPhase::CPhase(int qubit_index_a, int qubit_index_b, int line_number) : Operation(0, 80) {
+CPhase::CPhase(int qubit_index_a, int qubit_index_b, int line_number) : Operation(TimingTable::CPHASE) {
 	this->qubit_index_a = qubit_index_a;
 	this->qubit_index_b = qubit_index_b;
 	this->line_number = line_number;
@@ -124,45 +124,37 @@ void CPhase::add_dynamic_constraints(CrossbarModel* model, int curr_cycle) {
 		origin_right_j = origin_a_j;
 	}
 	
-	naxos::NsProblemManager* pm = model->get_problem_manager();
+	CycleConstraints* constraints = model->get_cycle_constraints();
 	
 	// Sites (reserve)
-	naxos::NsIntVar* site_a = model->get_position_qubits_constraint(origin_a_i, origin_a_j);
-	pm->add(*site_a == this->qubit_index_a);
+	constraints->fix_site(origin_a_i, origin_a_j, this->qubit_index_a);
 
-	naxos::NsIntVar* site_b = model->get_position_qubits_constraint(origin_b_i, origin_b_j);
-	pm->add(*site_b == this->qubit_index_b);
+	constraints->fix_site(origin_b_i, origin_b_j, this->qubit_index_b);
 
 	// Barriers
-	naxos::NsIntVar* middle_barrier = model->get_v_line_constraint(origin_left_j);
-	pm->add(*middle_barrier == 1);
+	constraints->fix_v_line(origin_left_j, 1);
 
 	if (origin_a_i - 1 >= 0) {
-		naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(origin_a_i - 1);
-		pm->add(*bottom_barrier == 0);
+		constraints->fix_h_line(origin_a_i - 1, 0);
 	}
 	if (origin_a_i <= m - 2) {
-		naxos::NsIntVar* top_barrier = model->get_h_line_constraint(origin_a_i);
-		pm->add(*top_barrier == 0);
+		constraints->fix_h_line(origin_a_i, 0);
 	}
 	if (origin_left_j - 1 >= 0) {
-		naxos::NsIntVar* left_barrier = model->get_v_line_constraint(origin_left_j - 1);
-		pm->add(*left_barrier == 0);
+		constraints->fix_v_line(origin_left_j - 1, 0);
 	}
 	if (origin_right_j <= n - 2) {
-		naxos::NsIntVar* right_barrier = model->get_v_line_constraint(origin_right_j);
-		pm->add(*right_barrier == 0);
+		constraints->fix_v_line(origin_right_j, 0);
 	}
 
 	// Qubit lines
-	naxos::NsIntVar* left_line = model->get_d_line_constraint(origin_a_j - origin_a_i);
-	naxos::NsIntVar* right_line = model->get_d_line_constraint(origin_b_j - origin_b_i);
-	pm->add(*left_line == *right_line);
+	constraints->compare_d_lines(origin_a_j - origin_a_i, LineConstraint::EQUAL, origin_b_j - origin_b_i);
 }
 
 void CPhase::execute(CrossbarModel* model, int curr_cycle, bool with_animation, int speed) {
 	// Evolve at the end by default
 	if (this->is_cycle(curr_cycle, 2)) {
 		model->evolve(this->get_involved_qubits());
+		model->apply_cz(this->qubit_index_a, this->qubit_index_b);
 	}
 }
@@ -1,12 +1,38 @@
 #include "Measurement.h"
 
-Measurement::Measurement(int ancilla_direction, int site_direction, int qubit_index, int line_number) : Operation(0, 80) {
+Measurement::Measurement(int ancilla_direction, int site_direction, int qubit_index, int line_number) : Operation(TimingTable::MEASUREMENT) {
 	this->ancilla_direction = ancilla_direction;
 	this->site_direction = site_direction;
 	this->qubit_index = qubit_index;
 	this->line_number = line_number;
 }
 
+/**
+ * The measured qubit and the ancilla next to it on the given crossbar
+ * (none if that site is empty: the checker reports it)
+ * @param model
+ */
+std::vector<int> Measurement::get_dependent_qubits(CrossbarModel* model) {
+	std::vector<int> qubits = {this->qubit_index};
+	QubitPosition* pos = model->get_position(this->qubit_index);
+	if (pos == NULL) return qubits;
+	
+	int m, n;
+	std::tie(m, n) = model->get_dimensions();
+	int ancilla_j = -1;
+	if (this->ancilla_direction == DIR_ANCILLA_LEFT) {
+		ancilla_j = pos->get_j() - 1;
+	} else if (this->ancilla_direction == DIR_ANCILLA_RIGHT) {
+		ancilla_j = pos->get_j() + 1;
+	}
+	if (ancilla_j >= 0 && ancilla_j < n) {
+		for (int q_id : model->get_qubits(pos->get_i(), ancilla_j)) {
+			qubits.push_back(q_id);
+		}
+	}
+	return qubits;
+}
+
 void Measurement::check_static_constraints(CrossbarModel* model) {
 	// Get info
 	Qubit* qubit = model->get_qubit(this->qubit_index);
@@ -19,6 +45,7 @@ void Measurement::check_static_constraints(CrossbarModel* model) {
 	
 	// 0. Check if an ancilla is adjacent to the qubit
 	Qubit* ancilla;
+	QubitState* ancilla_state;
 	std::set<int> ancilla_site_qubits;
 	if (this->ancilla_direction == DIR_ANCILLA_LEFT && origin_j > 0) {
 		ancilla_site_qubits = model->get_qubits(origin_i, origin_j - 1);
@@ -33,6 +60,7 @@ void Measurement::check_static_constraints(CrossbarModel* model) {
 	} else {
 		auto ancilla_index = *ancilla_site_qubits.begin();
 		ancilla = model->get_qubit(ancilla_index);
+		ancilla_state = model->get_qubit_state(ancilla_index);
 		
 		if (!ancilla->get_is_ancillary()) {
 			//throw std::runtime_error("Conflict: qubit adjacent to target is not an ancilla qubit");
@@ -53,8 +81,8 @@ void Measurement::check_static_constraints(CrossbarModel* model) {
 	
 	// 1. Ancilla must be in a known state |0> or |1>
 	std::complex<double> complex_one = 1;
-	if (!(origin_ancilla_j % 2 == 0 && ancilla->get_state()->get_beta() == complex_one)
-		&& !(origin_ancilla_j % 2 == 1 && ancilla->get_state()->get_alpha() == complex_one)) {
+	if (!(origin_ancilla_j % 2 == 0 && ancilla_state->get_beta() == complex_one)
+		&& !(origin_ancilla_j % 2 == 1 && ancilla_state->get_alpha() == complex_one)) {
 		throw std::runtime_error("Conflict: ancillary qubit must be in |0> or |1> state");
 	}
 	
@@ -68,7 +96,7 @@ void Measurement::check_static_constraints(CrossbarModel* model) {
 		throw std::runtime_error("Conflict: Measurement has an invalid site direction");
 	}
 	
-	if (!model->get_qubits(empty_site_i, origin_j).empty()) {
+	if (model->is_occupied(empty_site_i, origin_j)) {
 		throw std::runtime_error("Conflict: The site vertically adjacent to the measured qubit is not empty");
 	}
 	
@@ -157,7 +185,7 @@ void Measurement::add_dynamic_constraints(CrossbarModel* model, int curr_cycle)
 	int origin_i = pos->get_i();
 	int origin_j = pos->get_j();
 	
-	naxos::NsProblemManager* pm = model->get_problem_manager();
+	CycleConstraints* constraints = model->get_cycle_constraints();
 	
 	if (curr_cycle >= -1 && curr_cycle <= 2) {
 		// Shuttle to ancilla site
@@ -171,37 +199,28 @@ void Measurement::add_dynamic_constraints(CrossbarModel* model, int curr_cycle)
 		}
 		
 		// Sites
-		naxos::NsIntVar* origin_site = model->get_position_qubits_constraint(origin_i, origin_j);
-		pm->add(*origin_site == this->qubit_index);
+		constraints->fix_site(origin_i, origin_j, this->qubit_index);
 
-		naxos::NsIntVar* ancilla_site = model->get_position_qubits_constraint(origin_i, ancilla_origin_j);
-		pm->add(*ancilla_site == this->qubit_index);
+		constraints->fix_site(origin_i, ancilla_origin_j, this->qubit_index);
 
 		// Barriers
-		naxos::NsIntVar* middle_barrier = model->get_v_line_constraint(origin_j);
-		pm->add(*middle_barrier == 1);
+		constraints->fix_v_line(origin_j, 1);
 
 		if (origin_i > 0) {
-			naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(origin_i - 1);
-			pm->add(*bottom_barrier == 0);
+			constraints->fix_h_line(origin_i - 1, 0);
 		}
 		if (origin_i < n - 1) {
-			naxos::NsIntVar* top_barrier = model->get_h_line_constraint(origin_i);
-			pm->add(*top_barrier == 0);
+			constraints->fix_h_line(origin_i, 0);
 		}
 		if (origin_j > 0) {
-			naxos::NsIntVar* left_barrier = model->get_v_line_constraint(origin_j - 1);
-			pm->add(*left_barrier == 0);
+			constraints->fix_v_line(origin_j - 1, 0);
 		}
 		if (origin_j + 1 < n - 1) {
-			naxos::NsIntVar* right_barrier = model->get_v_line_constraint(origin_j + 1);
-			pm->add(*right_barrier == 0);
+			constraints->fix_v_line(origin_j + 1, 0);
 		}
 
 		// Qubit lines
-		naxos::NsIntVar* origin_line = model->get_d_line_constraint(origin_j - origin_i);
-		naxos::NsIntVar* ancilla_line = model->get_d_line_constraint(ancilla_origin_j - ancilla_origin_i);
-		pm->add(*origin_line > *ancilla_line);
+		constraints->compare_d_lines(origin_j - origin_i, LineConstraint::GREATER, ancilla_origin_j - ancilla_origin_i);
 		
 	} else if (curr_cycle <= 6) {
 		// Simulate the QL wave
@@ -220,37 +239,28 @@ void Measurement::add_dynamic_constraints(CrossbarModel* model, int curr_cycle)
 			}
 			
 			// Sites
-			naxos::NsIntVar* origin_site = model->get_position_qubits_constraint(origin_i, origin_j);
-			pm->add(*origin_site == this->qubit_index);
+			constraints->fix_site(origin_i, origin_j, this->qubit_index);
 
-			naxos::NsIntVar* ancilla_site = model->get_position_qubits_constraint(empty_site_i, empty_site_j);
-			pm->add(*ancilla_site == this->qubit_index);
+			constraints->fix_site(empty_site_i, empty_site_j, this->qubit_index);
 
 			// Barriers
-			naxos::NsIntVar* middle_barrier = model->get_h_line_constraint(h_barrier);
-			pm->add(*middle_barrier == 1);
+			constraints->fix_h_line(h_barrier, 1);
 
 			if (h_barrier > 0) {
-				naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(h_barrier - 1);
-				pm->add(*bottom_barrier == 0);
+				constraints->fix_h_line(h_barrier - 1, 0);
 			}
 			if (h_barrier < n - 2) {
-				naxos::NsIntVar* top_barrier = model->get_h_line_constraint(h_barrier + 1);
-				pm->add(*top_barrier == 0);
+				constraints->fix_h_line(h_barrier + 1, 0);
 			}
 			if (origin_j > 0) {
-				naxos::NsIntVar* left_barrier = model->get_v_line_constraint(origin_j - 1);
-				pm->add(*left_barrier == 0);
+				constraints->fix_v_line(origin_j - 1, 0);
 			}
 			if (origin_j + 1 < n - 1) {
-				naxos::NsIntVar* right_barrier = model->get_v_line_constraint(origin_j + 1);
-				pm->add(*right_barrier == 0);
+				constraints->fix_v_line(origin_j + 1, 0);
 			}
 
 			// Qubit lines
-			naxos::NsIntVar* origin_line = model->get_d_line_constraint(origin_j - origin_i);
-			naxos::NsIntVar* empty_line = model->get_d_line_constraint(empty_site_j - empty_site_i);
-			pm->add(*origin_line > *empty_line);
+			constraints->compare_d_lines(origin_j - origin_i, LineConstraint::GREATER, empty_site_j - empty_site_i);
 			
 		} else {
 			// Shuttle to empty siten
@@ -267,37 +277,28 @@ void Measurement::add_dynamic_constraints(CrossbarModel* model, int curr_cycle)
 			}
 			
 			// Sites
-			naxos::NsIntVar* origin_site = model->get_position_qubits_constraint(origin_i, origin_j);
-			pm->add(*origin_site == this->qubit_index);
+			constraints->fix_site(origin_i, origin_j, this->qubit_index);
 
-			naxos::NsIntVar* ancilla_site = model->get_position_qubits_constraint(empty_site_i, empty_site_j);
-			pm->add(*ancilla_site == this->qubit_index);
+			constraints->fix_site(empty_site_i, empty_site_j, this->qubit_index);
 
 			// Barriers
-			naxos::NsIntVar* middle_barrier = model->get_h_line_constraint(h_barrier);
-			pm->add(*middle_barrier == 1);
+			constraints->fix_h_line(h_barrier, 1);
 
 			if (h_barrier > 0) {
-				naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(h_barrier - 1);
-				pm->add(*bottom_barrier == 0);
+				constraints->fix_h_line(h_barrier - 1, 0);
 			}
 			if (h_barrier < n - 2) {
-				naxos::NsIntVar* top_barrier = model->get_h_line_constraint(h_barrier + 1);
-				pm->add(*top_barrier == 0);
+				constraints->fix_h_line(h_barrier + 1, 0);
 			}
 			if (origin_j > 0) {
-				naxos::NsIntVar* left_barrier = model->get_v_line_constraint(origin_j - 1);
-				pm->add(*left_barrier == 0);
+				constraints->fix_v_line(origin_j - 1, 0);
 			}
 			if (origin_j + 1 < n - 1) {
-				naxos::NsIntVar* right_barrier = model->get_v_line_constraint(origin_j + 1);
-				pm->add(*right_barrier == 0);
+				constraints->fix_v_line(origin_j + 1, 0);
 			}
 
 			// Qubit lines
-			naxos::NsIntVar* origin_line = model->get_d_line_constraint(origin_j - origin_i);
-			naxos::NsIntVar* empty_line = model->get_d_line_constraint(empty_site_j - empty_site_i);
-			pm->add(*origin_line < *empty_line);
+			constraints->compare_d_lines(origin_j - origin_i, LineConstraint::LESS, empty_site_j - empty_site_i);
 		}
 	}
 	
@@ -311,6 +312,11 @@ void Measurement::execute(CrossbarModel* model, int curr_cycle, bool with_animat
 		model->evolve(this->get_involved_qubits());
 	}
 	
+	// Read out at the end
+	if (this->is_cycle(curr_cycle, 8)) {
+		model->measure(this->qubit_index);
+	}
+	
 	// Qubit info
 	/*Qubit* qubit = model->get_qubit(this->qubit_index);
 	QubitPosition* pos = qubit->get_position();
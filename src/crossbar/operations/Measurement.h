@@ -26,6 +26,12 @@ public:
 		return {qubit_index};
 	}
 	
+	std::vector<int> get_dependent_qubits(CrossbarModel* model);
+	
+	std::vector<int> get_parameters() {
+		return {ancilla_direction, site_direction};
+	}
+	
 	friend std::ostream& operator<<(std::ostream &strm, const Measurement &gate) {
 		return strm << "Measurement " << std::to_string(gate.qubit_index)
 				<< ", " << std::to_string(gate.ancilla_direction)
@@ -1,20 +1,20 @@
 #ifndef OPERATION_H
 #define OPERATION_H
 
+#include <chrono>
 #include <thread>
-#include <QThread>
 #include <iostream>
-#include <naxos.h>
 
 #include "crossbar/CrossbarModel.h"
 
 class Operation {
 public:	
-	Operation(int latency, int duration) {
-		this->latency_ns = latency;
-		this->duration_ns = duration;
+	Operation(int kind) {
+		this->kind = kind;
 	}
 	
+	virtual ~Operation() {}
+	
 	virtual void check_static_constraints(CrossbarModel* model) = 0;
 	
 	virtual void add_dynamic_constraints(CrossbarModel* model, int curr_cycle) = 0;
@@ -23,12 +23,28 @@ public:
 	
 	virtual std::vector<int> get_involved_qubits() = 0;
 	
+	// Qubits that must not be used by other operations meanwhile (the
+	// involved ones and the ones it reads through on this crossbar)
+	virtual std::vector<int> get_dependent_qubits(CrossbarModel* model) {
+		return this->get_involved_qubits();
+	}
+	
+	// Extra values that change the constraints (directions, gate...)
+	virtual std::vector<int> get_parameters() {
+		return {};
+	}
+	
 	int get_line_number() {
 		return this->line_number;
 	}
 	
-	virtual int get_cycle_duration(int cycle_time) {
-		return (int) (this->duration_ns / cycle_time);
+	// Cycles from its start to its end and from its issue to its start
+	virtual int get_cycle_duration(const TimingTable& timing) {
+		return timing.get_cycles(this->kind);
+	}
+	
+	virtual int get_cycle_latency(const TimingTable& timing) {
+		return timing.get_latency_cycles(this->kind);
 	}
 	
 	friend std::ostream& operator<<(std::ostream& strm, const Operation& gate) {
@@ -36,12 +52,12 @@ public:
 	}
 	
 protected:
-	int latency_ns;
-	int duration_ns;
+	// TimingTable::KIND
+	int kind;
 	int line_number;
 
 	void wait(double seconds) {
-		QThread::msleep(seconds * 1000);
+		std::this_thread::sleep_for(std::chrono::milliseconds((long) (seconds * 1000)));
 	}
 
 	double get_waiting_seconds(int speed) {
@@ -1,6 +1,7 @@
 #include "ShuttleGate.h"
 
-ShuttleGate::ShuttleGate(int direction, int qubit_index, int line_number) : Operation(0, 20) {
+ShuttleGate::ShuttleGate(int direction, int qubit_index, int line_number, std::string gate) : Operation(TimingTable::SHUTTLE_GATE) {
+	this->gate = gate;
 	this->direction = direction;
 	this->qubit_index = qubit_index;
 	this->line_number = line_number;
@@ -70,8 +71,7 @@ void ShuttleGate::check_left_side(CrossbarModel* model, int origin_i, int origin
 	std::tie(m, n) = model->get_dimensions();
 	
 	// 1. Empty destination site
-	std::set<int> left_site = model->get_qubits(origin_i, left_j);
-	if (!left_site.empty()) {
+	if (model->is_occupied(origin_i, left_j)) {
 		throw std::runtime_error(
 			std::string("Conflict: the left adjacent site to ")
 			+ "(" + std::to_string(origin_i) + ", " + std::to_string(origin_j) + ")"
@@ -121,8 +121,7 @@ void ShuttleGate::check_right_side(CrossbarModel* model, int origin_i, int origi
 	std::tie(m, n) = model->get_dimensions();
 	
 	// 1. Empty destination site
-	std::set<int> right_site = model->get_qubits(origin_i, right_j);
-	if (!right_site.empty()) {
+	if (model->is_occupied(origin_i, right_j)) {
 		throw std::runtime_error(
 			std::string("Conflict:the right adjacent site to ")
 			+ "(" + std::to_string(origin_i) + ", " + std::to_string(origin_j) + ")"
@@ -209,41 +208,32 @@ void ShuttleGate::add_dynamic_constraints(CrossbarModel* model, int curr_cycle)
 		}
 	}
 	
-	naxos::NsProblemManager* pm = model->get_problem_manager();
+	CycleConstraints* constraints = model->get_cycle_constraints();
 	
 	// Sites
-	naxos::NsIntVar* origin_site = model->get_position_qubits_constraint(origin_i, origin_j);
-	pm->add(*origin_site == this->qubit_index);
+	constraints->fix_site(origin_i, origin_j, this->qubit_index);
 
 	// Destination
-	naxos::NsIntVar* destination_site = model->get_position_qubits_constraint(origin_i, dest_j);
-	pm->add(*destination_site == this->qubit_index);
+	constraints->fix_site(origin_i, dest_j, this->qubit_index);
 
 	// Barriers
-	naxos::NsIntVar* middle_barrier = model->get_v_line_constraint(v_barrier);
-	pm->add(*middle_barrier == 1);
+	constraints->fix_v_line(v_barrier, 1);
 
 	if (origin_i > 0) {
-		naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(origin_i - 1);
-		pm->add(*bottom_barrier == 0);
+		constraints->fix_h_line(origin_i - 1, 0);
 	}
 	if (origin_i < n - 1) {
-		naxos::NsIntVar* top_barrier = model->get_h_line_constraint(origin_i);
-		pm->add(*top_barrier == 0);
+		constraints->fix_h_line(origin_i, 0);
 	}
 	if (v_barrier > 0) {
-		naxos::NsIntVar* left_barrier = model->get_v_line_constraint(v_barrier - 1);
-		pm->add(*left_barrier == 0);
+		constraints->fix_v_line(v_barrier - 1, 0);
 	}
 	if (v_barrier < n - 2) {
-		naxos::NsIntVar* right_barrier = model->get_v_line_constraint(v_barrier + 1);
-		pm->add(*right_barrier == 0);
+		constraints->fix_v_line(v_barrier + 1, 0);
 	}
 
 	// Qubit lines
-	naxos::NsIntVar* origin_line = model->get_d_line_constraint(origin_j - origin_i);
-	naxos::NsIntVar* dest_line = model->get_d_line_constraint(dest_j - origin_i);
-	pm->add(*origin_line < *dest_line);
+	constraints->compare_d_lines(origin_j - origin_i, LineConstraint::LESS, dest_j - origin_i);
 }
 	
 void ShuttleGate::execute(CrossbarModel* model, int curr_cycle, bool with_animation, int speed) {
@@ -251,8 +241,9 @@ void ShuttleGate::execute(CrossbarModel* model, int curr_cycle, bool with_animat
 		// Go there
 		model->evolve(this->get_involved_qubits());
 	} else if (this->is_cycle(curr_cycle, 2)) {
-		// Come back
+		// Come back (the phase depends on the time spent at the other site)
 		model->evolve(this->get_involved_qubits());
+		model->apply_gate(this->gate, this->qubit_index);
 	}
 	
 	// Get info
@@ -299,6 +290,4 @@ void ShuttleGate::execute(CrossbarModel* model, int curr_cycle, bool with_animat
 	// Vertical barrier up
 	model->toggle_v_line(v_barrier);
 	if (with_animation) this->wait(waiting_seconds);*/
-	
-	// TODO: apply z gate with latency to model and qubit state
 }
@@ -13,7 +13,7 @@ public:
 	static const int DIR_LEFT = -1;
 	static const int DIR_RIGHT = 1;
 	
-	ShuttleGate(int direction, int qubit_index, int line_number = 0);
+	ShuttleGate(int direction, int qubit_index, int line_number = 0, std::string gate = "z");
 	
 	void check_static_constraints(CrossbarModel* model);
 	void check_left_side(CrossbarModel* model, int origin_i, int origin_j, int left_j, int right_j);
@@ -27,12 +27,17 @@ public:
 		return {qubit_index};
 	}
 	
+	std::vector<int> get_parameters() {
+		return {direction};
+	}
+	
 	friend std::ostream& operator<<(std::ostream &strm, const ShuttleGate &gate) {
 		return strm << "ShuttleGate " << std::to_string(gate.qubit_index)
 				<< " dir " << std::to_string(gate.direction);
 	}
 	
 private:
+	std::string gate;
 	int qubit_index;
 	int direction;
 };
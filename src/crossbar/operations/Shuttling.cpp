@@ -1,6 +1,6 @@
 #include "Shuttling.h"
 
-Shuttling::Shuttling(int direction, int qubit_index, int line_number) : Operation(0, 20) {
+Shuttling::Shuttling(int direction, int qubit_index, int line_number) : Operation(TimingTable::SHUTTLE) {
 	this->direction = direction;
 	this->qubit_index = qubit_index;
 	this->line_number = line_number;
@@ -17,8 +17,6 @@ void Shuttling::check_static_constraints(CrossbarModel* model) {
 	int origin_i = pos->get_i();
 	int origin_j = pos->get_j();
 	
-	std::set<int> dest_site;
-	
 	// Constraints
 	switch (this->direction) {
 		case Shuttling::DIR_UP:
@@ -30,8 +28,7 @@ void Shuttling::check_static_constraints(CrossbarModel* model) {
 			}
 
 			// 1. Empty spot
-			dest_site = model->get_qubits(origin_i + 1, origin_j);
-			if (!dest_site.empty()) {
+			if (model->is_occupied(origin_i + 1, origin_j)) {
 				throw std::runtime_error(
 					std::string("Conflict: Site destination ")
 					+ "(" + std::to_string(origin_i + 1) + ", " + std::to_string(origin_j) + ")"
@@ -107,8 +104,7 @@ void Shuttling::check_static_constraints(CrossbarModel* model) {
 			}
 
 			// 1. Empty spot
-			dest_site = model->get_qubits(origin_i - 1, origin_j);
-			if (!dest_site.empty()) {
+			if (model->is_occupied(origin_i - 1, origin_j)) {
 				throw std::runtime_error(
 					std::string("Conflict: Site destination ")
 					+ "(" + std::to_string(origin_i - 1) + ", " + std::to_string(origin_j) + ")"
@@ -184,8 +180,7 @@ void Shuttling::check_static_constraints(CrossbarModel* model) {
 			}
 
 			// 1. Empty spot
-			dest_site = model->get_qubits(origin_i, origin_j - 1);
-			if (!dest_site.empty()) {
+			if (model->is_occupied(origin_i, origin_j - 1)) {
 				throw std::runtime_error(
 					std::string("Conflict: Site destination ")
 					+ "(" + std::to_string(origin_i) + ", " + std::to_string(origin_j - 1) + ")"
@@ -261,8 +256,7 @@ void Shuttling::check_static_constraints(CrossbarModel* model) {
 			}
 
 			// 1. Empty spot
-			dest_site = model->get_qubits(origin_i, origin_j + 1);
-			if (!dest_site.empty()) {
+			if (model->is_occupied(origin_i, origin_j + 1)) {
 				throw std::runtime_error(
 					std::string("Conflict: Site destination ")
 					+ "(" + std::to_string(origin_i) + ", " + std::to_string(origin_j + 1) + ")"
@@ -346,150 +340,114 @@ void Shuttling::add_dynamic_constraints(CrossbarModel* model, int curr_cycle) {
 	int origin_i = pos->get_i();
 	int origin_j = pos->get_j();
 	
-	naxos::NsProblemManager* pm = model->get_problem_manager();
+	CycleConstraints* constraints = model->get_cycle_constraints();
     
 	switch (this->direction) {
 		case Shuttling::DIR_UP: {
 			// Sites
-			naxos::NsIntVar* origin_site = model->get_position_qubits_constraint(origin_i, origin_j);
-			pm->add(*origin_site == this->qubit_index);
+			constraints->fix_site(origin_i, origin_j, this->qubit_index);
 			
-			naxos::NsIntVar* destination_site = model->get_position_qubits_constraint(origin_i + 1, origin_j);
-			pm->add(*destination_site == this->qubit_index);
+			constraints->fix_site(origin_i + 1, origin_j, this->qubit_index);
 
 			// Barriers
-			naxos::NsIntVar* middle_barrier = model->get_h_line_constraint(origin_i);
-			pm->add(*middle_barrier == 1);
+			constraints->fix_h_line(origin_i, 1);
 
 			if (origin_i > 0) {
-				naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(origin_i - 1);
-				pm->add(*bottom_barrier == 0);
+				constraints->fix_h_line(origin_i - 1, 0);
 			}
 			if (origin_i + 1 < n - 1) {
-				naxos::NsIntVar* top_barrier = model->get_h_line_constraint(origin_i + 1);
-				pm->add(*top_barrier == 0);
+				constraints->fix_h_line(origin_i + 1, 0);
 			}
 			if (origin_j > 0) {
-				naxos::NsIntVar* left_barrier = model->get_v_line_constraint(origin_j - 1);
-				pm->add(*left_barrier == 0);
+				constraints->fix_v_line(origin_j - 1, 0);
 			}
 			if (origin_j < n - 1) {
-				naxos::NsIntVar* right_barrier = model->get_v_line_constraint(origin_j);
-				pm->add(*right_barrier == 0);
+				constraints->fix_v_line(origin_j, 0);
 			}
 			
 			// Qubit lines
-			naxos::NsIntVar* left_line = model->get_d_line_constraint(origin_j - origin_i - 1);
-			naxos::NsIntVar* right_line = model->get_d_line_constraint(origin_j - origin_i);
-			pm->add(*left_line > *right_line);
+			constraints->compare_d_lines(origin_j - origin_i - 1, LineConstraint::GREATER, origin_j - origin_i);
 			
 			break;
 		}
 		case Shuttling::DIR_DOWN: {
 			// Sites
-			naxos::NsIntVar* origin_site = model->get_position_qubits_constraint(origin_i, origin_j);
-			pm->add(*origin_site == this->qubit_index);
+			constraints->fix_site(origin_i, origin_j, this->qubit_index);
 			
-			naxos::NsIntVar* destination_site = model->get_position_qubits_constraint(origin_i - 1, origin_j);
-			pm->add(*destination_site == this->qubit_index);
+			constraints->fix_site(origin_i - 1, origin_j, this->qubit_index);
 			
 			// Barriers
-			naxos::NsIntVar* middle_barrier = model->get_h_line_constraint(origin_i - 1);
-			pm->add(*middle_barrier == 1);
+			constraints->fix_h_line(origin_i - 1, 1);
 			
 			if (origin_i - 1 > 0) {
-				naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(origin_i - 2);
-				pm->add(*bottom_barrier == 0);
+				constraints->fix_h_line(origin_i - 2, 0);
 			}
 			if (origin_i < n - 1) {
-				naxos::NsIntVar* top_barrier = model->get_h_line_constraint(origin_i);
-				pm->add(*top_barrier == 0);
+				constraints->fix_h_line(origin_i, 0);
 			}
 			if (origin_j > 0) {
-				naxos::NsIntVar* left_barrier = model->get_v_line_constraint(origin_j - 1);
-				pm->add(*left_barrier == 0);
+				constraints->fix_v_line(origin_j - 1, 0);
 			}
 			if (origin_j < n - 1) {
-				naxos::NsIntVar* right_barrier = model->get_v_line_constraint(origin_j);
-				pm->add(*right_barrier == 0);
+				constraints->fix_v_line(origin_j, 0);
 			}
 			
 			// Qubit lines
-			naxos::NsIntVar* left_line = model->get_d_line_constraint(origin_j - origin_i);
-			naxos::NsIntVar* right_line = model->get_d_line_constraint(origin_j - origin_i + 1);
-			pm->add(*left_line < *right_line);
+			constraints->compare_d_lines(origin_j - origin_i, LineConstraint::LESS, origin_j - origin_i + 1);
 			
 			break;
 		}
 		case Shuttling::DIR_LEFT: {
 			// Sites
-			naxos::NsIntVar* origin_site = model->get_position_qubits_constraint(origin_i, origin_j);
-			pm->add(*origin_site == this->qubit_index);
+			constraints->fix_site(origin_i, origin_j, this->qubit_index);
 			
-			naxos::NsIntVar* destination_site = model->get_position_qubits_constraint(origin_i, origin_j - 1);
-			pm->add(*destination_site == this->qubit_index);
+			constraints->fix_site(origin_i, origin_j - 1, this->qubit_index);
 			
 			// Barriers
-			naxos::NsIntVar* middle_barrier = model->get_v_line_constraint(origin_j - 1);
-			pm->add(*middle_barrier == 1);
+			constraints->fix_v_line(origin_j - 1, 1);
 			
 			if (origin_i > 0) {
-				naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(origin_i - 1);
-				pm->add(*bottom_barrier == 0);
+				constraints->fix_h_line(origin_i - 1, 0);
 			}
 			if (origin_i < n - 1) {
-				naxos::NsIntVar* top_barrier = model->get_h_line_constraint(origin_i);
-				pm->add(*top_barrier == 0);
+				constraints->fix_h_line(origin_i, 0);
 			}
 			if (origin_j - 1 > 0) {
-				naxos::NsIntVar* left_barrier = model->get_v_line_constraint(origin_j - 2);
-				pm->add(*left_barrier == 0);
+				constraints->fix_v_line(origin_j - 2, 0);
 			}
 			if (origin_j < n - 1) {
-				naxos::NsIntVar* right_barrier = model->get_v_line_constraint(origin_j);
-				pm->add(*right_barrier == 0);
+				constraints->fix_v_line(origin_j, 0);
 			}
 			
 			// Qubit lines
-			naxos::NsIntVar* left_line = model->get_d_line_constraint(origin_j - origin_i - 1);
-			naxos::NsIntVar* right_line = model->get_d_line_constraint(origin_j - origin_i);
-			pm->add(*left_line > *right_line);
+			constraints->compare_d_lines(origin_j - origin_i - 1, LineConstraint::GREATER, origin_j - origin_i);
 			
 			break;
 		}
 		case Shuttling::DIR_RIGHT: {
 			// Sites
-			naxos::NsIntVar* origin_site = model->get_position_qubits_constraint(origin_i, origin_j);
-			pm->add(*origin_site == this->qubit_index);
+			constraints->fix_site(origin_i, origin_j, this->qubit_index);
 			
-			naxos::NsIntVar* destination_site = model->get_position_qubits_constraint(origin_i, origin_j + 1);
-			pm->add(*destination_site == this->qubit_index);
+			constraints->fix_site(origin_i, origin_j + 1, this->qubit_index);
 			
 			// Barriers
-			naxos::NsIntVar* middle_barrier = model->get_v_line_constraint(origin_j);
-			pm->add(*middle_barrier == 1);
+			constraints->fix_v_line(origin_j, 1);
 			
 			if (origin_i > 0) {
-				naxos::NsIntVar* bottom_barrier = model->get_h_line_constraint(origin_i - 1);
-				pm->add(*bottom_barrier == 0);
+				constraints->fix_h_line(origin_i - 1, 0);
 			}
 			if (origin_i < n - 1) {
-				naxos::NsIntVar* top_barrier = model->get_h_line_constraint(origin_i);
-				pm->add(*top_barrier == 0);
+				constraints->fix_h_line(origin_i, 0);
 			}
 			if (origin_j > 0) {
-				naxos::NsIntVar* left_barrier = model->get_v_line_constraint(origin_j - 1);
-				pm->add(*left_barrier == 0);
+				constraints->fix_v_line(origin_j - 1, 0);
 			}
 			if (origin_j + 1 < n - 1) {
-				naxos::NsIntVar* right_barrier = model->get_v_line_constraint(origin_j + 1);
-				pm->add(*right_barrier == 0);
+				constraints->fix_v_line(origin_j + 1, 0);
 			}
 			
 			// Qubit lines
-			naxos::NsIntVar* left_line = model->get_d_line_constraint(origin_j - origin_i);
-			naxos::NsIntVar* right_line = model->get_d_line_constraint(origin_j - origin_i + 1);
-			pm->add(*left_line < *right_line);
+			constraints->compare_d_lines(origin_j - origin_i, LineConstraint::LESS, origin_j - origin_i + 1);
 			
 			break;
 		}
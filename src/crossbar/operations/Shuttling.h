@@ -25,6 +25,10 @@ public:
 		return {qubit_index};
 	}
 	
+	std::vector<int> get_parameters() {
+		return {direction};
+	}
+	
 	friend std::ostream& operator<<(std::ostream &strm, const Shuttling &gate) {
 		return strm << "Shuttling " << std::to_string(gate.qubit_index)
 				<< " dir " << std::to_string(gate.direction);
@@ -1,7 +1,8 @@
 #include "SingleGate.h"
 
-SingleGate::SingleGate(std::string gate, int direction, int qubit_index, int line_number) : Operation(0, 40) {
+SingleGate::SingleGate(std::string gate, int direction, int qubit_index, int line_number, double angle) : Operation(TimingTable::SINGLE_GATE) {
 	this->gate = gate;
+	this->angle = angle;
 	this->direction = direction;
 	this->qubit_index = qubit_index;
 	this->line_number = line_number;
@@ -33,26 +34,23 @@ void SingleGate::check_static_constraints(CrossbarModel* model) {
 	
 	// Common barriers
 	
-	// Top barrier
-	for (int i = 0; i < m - 1; i++) {
-		if (model->is_h_barrier_down(i)) {
-			throw std::runtime_error(
-				std::string("Conflict: The horizontal barrier ")
-				+ std::to_string(i)
-				+ " is lowered"
-			);
-		}
+	// Horizontal barriers
+	const CrossbarBoard& board = model->get_board();
+	if (board.any_h_barrier_down()) {
+		throw std::runtime_error(
+			std::string("Conflict: The horizontal barrier ")
+			+ std::to_string(board.first_h_barrier_down())
+			+ " is lowered"
+		);
 	}
 	
-	// Bottom barrier
-	for (int j = 0; j < n - 1; j++) {
-		if (model->is_v_barrier_down(j)) {
-			throw std::runtime_error(
-				std::string("Conflict: The vertical barrier ")
-				+ std::to_string(j)
-				+ " is lowered"
-			);
-		}
+	// Vertical barriers
+	if (board.any_v_barrier_down()) {
+		throw std::runtime_error(
+			std::string("Conflict: The vertical barrier ")
+			+ std::to_string(board.first_v_barrier_down())
+			+ " is lowered"
+		);
 	}
 	
 	// 1. Empty destination site
@@ -82,8 +80,7 @@ void SingleGate::check_left_side(CrossbarModel* model, int origin_i, int origin_
 	std::tie(m, n) = model->get_dimensions();
 	
 	// 1. Empty destination site
-	std::set<int> left_site = model->get_qubits(origin_i, left_j);
-	if (!left_site.empty()) {
+	if (model->is_occupied(origin_i, left_j)) {
 		throw std::runtime_error(
 			std::string("Conflict: the left adjacent site to ")
 			+ "(" + std::to_string(origin_i) + ", " + std::to_string(origin_j) + ")"
@@ -132,8 +129,7 @@ void SingleGate::check_right_side(CrossbarModel* model, int origin_i, int origin
 	std::tie(m, n) = model->get_dimensions();
 	
 	// 1. Empty destination site
-	std::set<int> right_site = model->get_qubits(origin_i, right_j);
-	if (!right_site.empty()) {
+	if (model->is_occupied(origin_i, right_j)) {
 		throw std::runtime_error(
 			std::string("Conflict: the right adjacent site to ")
 			+ "(" + std::to_string(origin_i) + ", " + std::to_string(origin_j) + ")"
@@ -187,7 +183,7 @@ void SingleGate::add_dynamic_constraints(CrossbarModel* model, int curr_cycle) {
 	int origin_i = pos->get_i();
 	int origin_j = pos->get_j();
 	
-	naxos::NsProblemManager* pm = model->get_problem_manager();
+	CycleConstraints* constraints = model->get_cycle_constraints();
 	
 	// Sites
 	/*naxos::NsIntVar* originSite = model->get_position_qubits_constraint(origin_i, origin_j);
@@ -197,32 +193,32 @@ void SingleGate::add_dynamic_constraints(CrossbarModel* model, int curr_cycle) {
 	pm->add(*destinationSite == this->qubit_index);*/
 	
 	// Barriers
-	for (int k = 0; k < (n - 1); k++) {
+	for (int k = 0; k < (m - 1); k++) {
 		// Horizontal
-		naxos::NsIntVar* h_barrier = model->get_h_line_constraint(k);
-		pm->add(*h_barrier == 0);
+		constraints->fix_h_line(k, 0);
 	}
 	
-	for (int k = 0; k < (m - 1); k++) {
+	for (int k = 0; k < (n - 1); k++) {
 		// Vertical
-		naxos::NsIntVar* v_barrier = model->get_v_line_constraint(k);
-		pm->add(*v_barrier == 0);
+		constraints->fix_v_line(k, 0);
 	}
 	
 	// Qubit lines
 	for (int k = -1 * (n - 1); k <= (m - 1); k++) {
-		naxos::NsIntVar* d_line = model->get_d_line_constraint(k);
-		pm->add(*d_line == 0);
+		constraints->fix_d_line(k, 0);
 	}
 	
 	// Wave
-	naxos::NsIntVar* wave = model->get_wave_constraint();
-	naxos::NsIntVar* wave_column = model->get_wave_column_constraint();
-	pm->add(*wave == this->get_wave_hash());
-	pm->add(*wave_column == (origin_j % 2));
+	constraints->fix_wave(this->get_wave_hash());
+	constraints->fix_wave_column(origin_j % 2);
 }
 
 void SingleGate::execute(CrossbarModel* model, int curr_cycle, bool with_animation, int speed) {
+	// Rotate at the end of the global operation
+	if (this->is_cycle(curr_cycle, 4)) {
+		model->apply_gate(this->gate, this->qubit_index, this->angle);
+	}
+	
 	// Qubit info
 	/*Qubit* qubit = model->get_qubit(this->qubit_index);
 	QubitPosition* pos = qubit->get_position();
@@ -9,7 +9,7 @@ public:
 	static const int DIR_LEFT = -1;
 	static const int DIR_RIGHT = 1;
 
-	SingleGate(std::string gate, int direction, int qubit_index, int line_number = 0);
+	SingleGate(std::string gate, int direction, int qubit_index, int line_number = 0, double angle = 0);
 	
 	void check_static_constraints(CrossbarModel* model);
 	void check_left_side(CrossbarModel* model, int origin_i, int origin_j, int left_j, int right_j);
@@ -23,6 +23,10 @@ public:
 		return {qubit_index};
 	}
 	
+	std::vector<int> get_parameters() {
+		return {direction, get_wave_hash()};
+	}
+	
 	friend std::ostream& operator<<(std::ostream &strm, const SingleGate &gate) {
 		return strm << "SingleGate " << std::to_string(gate.qubit_index)
 				<< " dir " << std::to_string(gate.direction);
@@ -30,6 +34,7 @@ public:
 	
 private:
 	std::string gate;
+	double angle;
 	int qubit_index;
 	int direction;
 	
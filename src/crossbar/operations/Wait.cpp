@@ -1,6 +1,6 @@
 #include "Wait.h"
 
-Wait::Wait(int cycles, int line_number) : Operation(0, 0) {
+Wait::Wait(int cycles, int line_number) : Operation(-1) {
 	this->cycles = cycles;
 	this->line_number = line_number;
 }
@@ -17,10 +17,18 @@ public:
 		return {};
 	}
 	
-	int get_cycle_duration(int cycle_time) {
+	std::vector<int> get_parameters() {
+		return {cycles};
+	}
+	
+	int get_cycle_duration(const TimingTable& timing) {
 		return this->cycles;
 	}
 	
+	int get_cycle_latency(const TimingTable& timing) {
+		return 0;
+	}
+	
 	friend std::ostream& operator<<(std::ostream &strm, const Wait &gate) {
 		return strm << "Wait " << std::to_string(gate.cycles);
 	}
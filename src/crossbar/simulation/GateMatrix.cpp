@@ -0,0 +1,87 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "GateMatrix.h"
+
+GateMatrix::GateMatrix() : GateMatrix(1, 0, 0, 1) {
+
+}
+
+GateMatrix::GateMatrix(std::complex<double> m00, std::complex<double> m01,
+		std::complex<double> m10, std::complex<double> m11) {
+	this->m[0] = m00;
+	this->m[1] = m01;
+	this->m[2] = m10;
+	this->m[3] = m11;
+}
+
+/**
+ * Get the unitary of a cQASM one-qubit gate
+ * @param gate name in lower case ("h", "x", "rx", "sdag"...)
+ * @param angle rotation angle (only for "rx", "ry" and "rz")
+ * @return matrix
+ */
+GateMatrix GateMatrix::from_name(const std::string& gate, double angle) {
+	const std::complex<double> i(0, 1);
+	const double half_sqrt = 1 / std::sqrt(2.0);
+
+	if (gate == "i") {
+		return GateMatrix();
+	} else if (gate == "h") {
+		return GateMatrix(half_sqrt, half_sqrt, half_sqrt, -half_sqrt);
+	} else if (gate == "x") {
+		return GateMatrix(0, 1, 1, 0);
+	} else if (gate == "y") {
+		return GateMatrix(0, -i, i, 0);
+	} else if (gate == "z") {
+		return GateMatrix(1, 0, 0, -1);
+	} else if (gate == "s") {
+		return GateMatrix(1, 0, 0, i);
+	} else if (gate == "sdag") {
+		return GateMatrix(1, 0, 0, -i);
+	} else if (gate == "t") {
+		return GateMatrix(1, 0, 0, std::polar(1.0, M_PI / 4));
+	} else if (gate == "tdag") {
+		return GateMatrix(1, 0, 0, std::polar(1.0, -M_PI / 4));
+	} else if (gate == "rx" || gate == "x90" || gate == "mx90") {
+		if (gate == "x90") angle = M_PI / 2;
+		if (gate == "mx90") angle = -M_PI / 2;
+		double c = std::cos(angle / 2);
+		double s = std::sin(angle / 2);
+		return GateMatrix(c, -i * s, -i * s, c);
+	} else if (gate == "ry" || gate == "y90" || gate == "my90") {
+		if (gate == "y90") angle = M_PI / 2;
+		if (gate == "my90") angle = -M_PI / 2;
+		double c = std::cos(angle / 2);
+		double s = std::sin(angle / 2);
+		return GateMatrix(c, -s, s, c);
+	} else if (gate == "rz") {
+		return GateMatrix(std::polar(1.0, -angle / 2), 0, 0, std::polar(1.0, angle / 2));
+	}
+
+	throw std::runtime_error("Gate `" + gate + "` has no unitary");
+}
+
+bool GateMatrix::is_unitary_gate(const std::string& gate) {
+	return gate == "i" || gate == "h" || gate == "x" || gate == "y" || gate == "z"
+		|| gate == "s" || gate == "sdag" || gate == "t" || gate == "tdag"
+		|| gate == "rx" || gate == "ry" || gate == "rz"
+		|| gate == "x90" || gate == "y90" || gate == "mx90" || gate == "my90";
+}
+
+bool GateMatrix::is_diagonal() const {
+	return this->m[1] == 0.0 && this->m[2] == 0.0;
+}
+
+bool GateMatrix::is_identity() const {
+	return this->is_diagonal() && this->m[0] == 1.0 && this->m[3] == 1.0;
+}
+
+GateMatrix GateMatrix::operator*(const GateMatrix& other) const {
+	return GateMatrix(
+		this->m[0] * other.m[0] + this->m[1] * other.m[2],
+		this->m[0] * other.m[1] + this->m[1] * other.m[3],
+		this->m[2] * other.m[0] + this->m[3] * other.m[2],
+		this->m[2] * other.m[1] + this->m[3] * other.m[3]
+	);
+}
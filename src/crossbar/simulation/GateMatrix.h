@@ -0,0 +1,33 @@
+#ifndef CROSSBAR_SIMULATOR_GATEMATRIX_H
+#define CROSSBAR_SIMULATOR_GATEMATRIX_H
+
+#include <string>
+#include <complex>
+
+/**
+ * Unitary of a one-qubit gate (row-major 2x2 matrix)
+ */
+class GateMatrix {
+public:
+	GateMatrix();
+	GateMatrix(std::complex<double> m00, std::complex<double> m01,
+		std::complex<double> m10, std::complex<double> m11);
+
+	static GateMatrix from_name(const std::string& gate, double angle = 0);
+	static bool is_unitary_gate(const std::string& gate);
+
+	const std::complex<double>& get(int row, int col) const {
+		return this->m[2 * row + col];
+	}
+
+	bool is_diagonal() const;
+	bool is_identity() const;
+
+	// Product (this gate after the other one)
+	GateMatrix operator*(const GateMatrix& other) const;
+
+private:
+	std::complex<double> m[4];
+};
+
+#endif /* CROSSBAR_SIMULATOR_GATEMATRIX_H */
@@ -0,0 +1,59 @@
+#include <math.h>
+#include <algorithm>
+
+#include "NoiseModel.h"
+
+NoiseModel::NoiseModel() {
+	this->cycle_time = 10;
+	this->relaxation_time = 0;
+	this->shuttle_error = 0;
+}
+
+double NoiseModel::get_cycle_time() const {
+	return this->cycle_time;
+}
+
+void NoiseModel::set_cycle_time(double cycle_time) {
+	this->cycle_time = cycle_time;
+}
+
+double NoiseModel::get_relaxation_time() const {
+	return this->relaxation_time;
+}
+
+void NoiseModel::set_relaxation_time(double relaxation_time) {
+	this->relaxation_time = relaxation_time;
+}
+
+double NoiseModel::get_shuttle_error() const {
+	return this->shuttle_error;
+}
+
+void NoiseModel::set_shuttle_error(double shuttle_error) {
+	this->shuttle_error = shuttle_error;
+}
+
+/**
+ * Probabilities of an X, Y and Z error on a qubit during one cycle
+ * @param dephasing_time pure dephasing time of the qubit (0: none)
+ * @param shuttled whether the qubit made a shuttle step in the cycle
+ * @param p_x
+ * @param p_y
+ * @param p_z
+ */
+void NoiseModel::get_error_probabilities(double dephasing_time, bool shuttled,
+		double& p_x, double& p_y, double& p_z) const {
+	double decay_rate = 0;
+	if (this->relaxation_time > 0) decay_rate += 1 / (2 * this->relaxation_time);
+	if (dephasing_time > 0) decay_rate += 1 / dephasing_time;
+
+	double relaxation = (this->relaxation_time > 0) ? 1 - exp(-this->cycle_time / this->relaxation_time) : 0;
+	p_x = relaxation / 4;
+	p_y = relaxation / 4;
+	p_z = std::max(0.0, (1 - exp(-this->cycle_time * decay_rate)) / 2 - p_x);
+
+	// Independent phase flip of the step
+	if (shuttled) {
+		p_z = p_z + this->shuttle_error - 2 * p_z * this->shuttle_error;
+	}
+}
@@ -0,0 +1,32 @@
+#ifndef CROSSBAR_SIMULATOR_NOISEMODEL_H
+#define CROSSBAR_SIMULATOR_NOISEMODEL_H
+
+/**
+ * Decoherence of the qubits as Pauli errors per cycle (Pauli twirl of
+ * amplitude and phase damping). The pure dephasing time is a property
+ * of every qubit (Qubit::dephasing_time); a shuttle step adds a phase
+ * flip with a fixed probability. Times are in ns, 0 means no decay.
+ */
+class NoiseModel {
+public:
+	NoiseModel();
+
+	double get_cycle_time() const;
+	void set_cycle_time(double cycle_time);
+
+	double get_relaxation_time() const;
+	void set_relaxation_time(double relaxation_time);
+
+	double get_shuttle_error() const;
+	void set_shuttle_error(double shuttle_error);
+
+	void get_error_probabilities(double dephasing_time, bool shuttled,
+		double& p_x, double& p_y, double& p_z) const;
+
+private:
+	double cycle_time;
+	double relaxation_time;
+	double shuttle_error;
+};
+
+#endif /* CROSSBAR_SIMULATOR_NOISEMODEL_H */
@@ -0,0 +1,117 @@
+#include <math.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "PauliFrames.h"
+
+/**
+ * Frames without errors
+ * @param num_qubits
+ * @param num_shots
+ */
+PauliFrames::PauliFrames(int num_qubits, int num_shots) {
+	if (num_qubits < 0 || num_shots < 0) {
+		throw std::runtime_error("Invalid size of the Pauli frames");
+	}
+	this->num_qubits = num_qubits;
+	this->num_shots = num_shots;
+	this->words = (num_shots + 63) / 64;
+	this->x_bits.assign(num_qubits * this->words, 0);
+	this->z_bits.assign(num_qubits * this->words, 0);
+}
+
+int PauliFrames::get_num_qubits() const {
+	return this->num_qubits;
+}
+
+int PauliFrames::get_num_shots() const {
+	return this->num_shots;
+}
+
+/**
+ * Conjugate the errors of a qubit by a gate (signs are irrelevant)
+ * @param gate cQASM name in lower case
+ * @param qubit
+ */
+void PauliFrames::apply_gate(const std::string& gate, int qubit) {
+	this->check_qubit(qubit);
+	uint64_t* x = &this->x_bits[qubit * this->words];
+	uint64_t* z = &this->z_bits[qubit * this->words];
+
+	if (gate == "h" || gate == "y90" || gate == "my90") {
+		std::swap_ranges(x, x + this->words, z);
+	} else if (gate == "s" || gate == "sdag") {
+		for (int w = 0; w < this->words; w++) z[w] ^= x[w];
+	} else if (gate == "x90" || gate == "mx90") {
+		for (int w = 0; w < this->words; w++) x[w] ^= z[w];
+	} else if (gate == "prep_x" || gate == "prep_y" || gate == "prep_z") {
+		std::fill(x, x + this->words, 0);
+		std::fill(z, z + this->words, 0);
+	}
+}
+
+void PauliFrames::apply_cz(int qubit_a, int qubit_b) {
+	this->check_qubit(qubit_a);
+	this->check_qubit(qubit_b);
+	const uint64_t* x_a = &this->x_bits[qubit_a * this->words];
+	const uint64_t* x_b = &this->x_bits[qubit_b * this->words];
+	uint64_t* z_a = &this->z_bits[qubit_a * this->words];
+	uint64_t* z_b = &this->z_bits[qubit_b * this->words];
+
+	for (int w = 0; w < this->words; w++) {
+		z_a[w] ^= x_b[w];
+		z_b[w] ^= x_a[w];
+	}
+}
+
+/**
+ * Add independent X, Y and Z errors to every shot of a qubit
+ * @param qubit
+ * @param p_x
+ * @param p_y
+ * @param p_z
+ * @param random
+ */
+void PauliFrames::inject(int qubit, double p_x, double p_y, double p_z, RandomGenerator& random) {
+	this->check_qubit(qubit);
+	this->sample_flips(qubit, p_x, true, false, random);
+	this->sample_flips(qubit, p_y, true, true, random);
+	this->sample_flips(qubit, p_z, false, true, random);
+}
+
+/**
+ * @return bit k is set if the outcome of shot k is flipped
+ */
+std::vector<uint64_t> PauliFrames::get_measurement_flips(int qubit) const {
+	this->check_qubit(qubit);
+	return std::vector<uint64_t>(this->x_bits.begin() + qubit * this->words,
+		this->x_bits.begin() + (qubit + 1) * this->words);
+}
+
+/**
+ * Flip the shots with an error, jumping from one to the next with the
+ * geometric distribution (the cost is the number of errors, not shots)
+ */
+void PauliFrames::sample_flips(int qubit, double probability, bool x, bool z, RandomGenerator& random) {
+	if (probability <= 0) return;
+
+	uint64_t* x_row = &this->x_bits[qubit * this->words];
+	uint64_t* z_row = &this->z_bits[qubit * this->words];
+	double log_miss = (probability < 1) ? log(1 - probability) : -INFINITY;
+	double shot = -1;
+	while (true) {
+		shot += 1 + floor(log(1 - random.uniform()) / log_miss);
+		if (shot >= this->num_shots) break;
+
+		int k = (int) shot;
+		uint64_t mask = (uint64_t) 1 << (k % 64);
+		if (x) x_row[k / 64] ^= mask;
+		if (z) z_row[k / 64] ^= mask;
+	}
+}
+
+void PauliFrames::check_qubit(int qubit) const {
+	if (qubit < 0 || qubit >= this->num_qubits) {
+		throw std::runtime_error("Qubit " + std::to_string(qubit) + " is not in the Pauli frames");
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef CROSSBAR_SIMULATOR_PAULIFRAMES_H
+#define CROSSBAR_SIMULATOR_PAULIFRAMES_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "RandomGenerator.h"
+
+/**
+ * Pauli errors of many shots at once, propagated through the gates
+ * instead of simulating every noisy shot. Bit k of the X and Z words of
+ * a qubit is the error of shot k, so a gate updates 64 shots per word.
+ * Non-Clifford gates leave the frame unchanged (twirl approximation).
+ */
+class PauliFrames {
+public:
+	PauliFrames(int num_qubits, int num_shots);
+
+	int get_num_qubits() const;
+	int get_num_shots() const;
+
+	// Gates by cQASM name (and "prep_x", "prep_y", "prep_z")
+	void apply_gate(const std::string& gate, int qubit);
+	void apply_cz(int qubit_a, int qubit_b);
+
+	void inject(int qubit, double p_x, double p_y, double p_z, RandomGenerator& random);
+
+	// Shots whose Z measurement outcome is flipped
+	std::vector<uint64_t> get_measurement_flips(int qubit) const;
+
+private:
+	int num_qubits;
+	int num_shots;
+	int words;
+
+	// Qubit q: words [q * words, (q + 1) * words)
+	std::vector<uint64_t> x_bits;
+	std::vector<uint64_t> z_bits;
+
+	void sample_flips(int qubit, double probability, bool x, bool z, RandomGenerator& random);
+	void check_qubit(int qubit) const;
+};
+
+#endif /* CROSSBAR_SIMULATOR_PAULIFRAMES_H */
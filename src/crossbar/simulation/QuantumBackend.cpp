@@ -0,0 +1,26 @@
+#include <stdexcept>
+
+#include "QuantumBackend.h"
+#include "StatevectorBackend.h"
+#include "StabilizerBackend.h"
+
+/**
+ * Create a quantum backend by name
+ * @param name "statevector" or "stabilizer" (Clifford gates only)
+ * @param num_qubits
+ * @param num_threads threads of the statevector kernels (0: one per core)
+ * @return new backend with all the qubits in |0>
+ */
+QuantumBackend* QuantumBackend::create(const std::string& name, int num_qubits, int num_threads) {
+	if (name == "statevector") {
+		return new StatevectorBackend(num_qubits, num_threads);
+	} else if (name == "stabilizer") {
+		return new StabilizerBackend(num_qubits);
+	}
+
+	throw std::runtime_error("Unknown simulation backend '" + name + "'");
+}
+
+std::vector<std::string> QuantumBackend::get_names() {
+	return {"statevector", "stabilizer"};
+}
@@ -0,0 +1,48 @@
+#ifndef CROSSBAR_SIMULATOR_QUANTUMBACKEND_H
+#define CROSSBAR_SIMULATOR_QUANTUMBACKEND_H
+
+#include <string>
+#include <vector>
+#include <complex>
+
+/**
+ * Quantum state of all the qubits of the crossbar. Qubit q_id is qubit
+ * q_id of the register.
+ */
+class QuantumBackend {
+public:
+	virtual ~QuantumBackend() {}
+
+	virtual std::string get_name() = 0;
+	virtual QuantumBackend* clone() = 0;
+	virtual int get_num_qubits() = 0;
+
+	/**
+	 * Set the register to the product of one-qubit states
+	 * @throws std::runtime_error if the backend can not represent it
+	 */
+	virtual void set_product_state(const std::vector<std::complex<double> >& alphas,
+		const std::vector<std::complex<double> >& betas) = 0;
+
+	/**
+	 * Apply a unitary one-qubit gate by its cQASM name
+	 * @throws std::runtime_error if the backend does not support it
+	 */
+	virtual void apply_gate(const std::string& gate, int qubit, double angle = 0) = 0;
+	virtual void apply_cz(int qubit_a, int qubit_b) = 0;
+	virtual void apply_sqswap(int qubit_a, int qubit_b) = 0;
+
+	// Z basis (random in [0, 1))
+	virtual int measure(int qubit, double random) = 0;
+	virtual double get_probability_one(int qubit) = 0;
+
+	// Apply the gates the backend has delayed, if any
+	virtual void flush() {}
+	// Check for delayed gates on a qubit (on any qubit if -1)
+	virtual bool has_pending_gates(int qubit = -1) const { return false; }
+
+	static QuantumBackend* create(const std::string& name, int num_qubits, int num_threads = 0);
+	static std::vector<std::string> get_names();
+};
+
+#endif /* CROSSBAR_SIMULATOR_QUANTUMBACKEND_H */
@@ -0,0 +1,70 @@
+#include "RandomGenerator.h"
+
+static inline uint64_t rotl(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+RandomGenerator::RandomGenerator(uint64_t seed) {
+	this->seed(seed);
+}
+
+/**
+ * Fill the state with splitmix64, so similar seeds give unrelated streams
+ * @param seed
+ */
+void RandomGenerator::seed(uint64_t seed) {
+	for (int k = 0; k < 4; k++) {
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		this->s[k] = z ^ (z >> 31);
+	}
+}
+
+uint64_t RandomGenerator::next() {
+	uint64_t result = rotl(this->s[1] * 5, 7) * 9;
+	uint64_t t = this->s[1] << 17;
+
+	this->s[2] ^= this->s[0];
+	this->s[3] ^= this->s[1];
+	this->s[1] ^= this->s[2];
+	this->s[0] ^= this->s[3];
+	this->s[2] ^= t;
+	this->s[3] = rotl(this->s[3], 45);
+
+	return result;
+}
+
+double RandomGenerator::uniform() {
+	return (this->next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Advance the state by 2^128 numbers
+ */
+void RandomGenerator::jump() {
+	static const uint64_t JUMP[] = {
+		0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+	};
+
+	uint64_t t[4] = {0, 0, 0, 0};
+	for (int k = 0; k < 4; k++) {
+		for (int b = 0; b < 64; b++) {
+			if (JUMP[k] & ((uint64_t) 1 << b)) {
+				for (int w = 0; w < 4; w++) t[w] ^= this->s[w];
+			}
+			this->next();
+		}
+	}
+	for (int w = 0; w < 4; w++) this->s[w] = t[w];
+}
+
+/**
+ * @param index
+ * @return generator of stream index (this one jumped index times)
+ */
+RandomGenerator RandomGenerator::get_stream(int index) const {
+	RandomGenerator stream(*this);
+	for (int k = 0; k < index; k++) stream.jump();
+	return stream;
+}
@@ -0,0 +1,28 @@
+#ifndef CROSSBAR_SIMULATOR_RANDOMGENERATOR_H
+#define CROSSBAR_SIMULATOR_RANDOMGENERATOR_H
+
+#include <stdint.h>
+
+/**
+ * Seedable xoshiro256** generator. Every thread that draws numbers gets
+ * its own stream: stream k starts 2^128 numbers after stream k - 1, so
+ * the streams never overlap and the results only depend on the seed.
+ */
+class RandomGenerator {
+public:
+	RandomGenerator(uint64_t seed = 0);
+
+	void seed(uint64_t seed);
+	uint64_t next();
+
+	// Uniform in [0, 1) with 53 random bits
+	double uniform();
+
+	void jump();
+	RandomGenerator get_stream(int index) const;
+
+private:
+	uint64_t s[4];
+};
+
+#endif /* CROSSBAR_SIMULATOR_RANDOMGENERATOR_H */
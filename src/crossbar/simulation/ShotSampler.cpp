@@ -0,0 +1,174 @@
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+
+#include "ShotSampler.h"
+#include "StatevectorBackend.h"
+#include "StabilizerBackend.h"
+
+/**
+ * @param state final state (not modified)
+ * @param qubits measured qubits, in the order of the outcome strings
+ * @throws std::runtime_error if the backend can not be sampled
+ */
+ShotSampler::ShotSampler(QuantumBackend* state, const std::vector<int>& qubits) {
+	this->qubits = qubits;
+	this->affine = false;
+
+	if (dynamic_cast<StatevectorBackend*>(state) != NULL) {
+		this->analyse_statevector(state);
+	} else if (dynamic_cast<StabilizerBackend*>(state) != NULL) {
+		this->analyse_stabilizer(state);
+	} else {
+		throw std::runtime_error("Unable to sample the " + state->get_name() + " backend");
+	}
+}
+
+const std::vector<int>& ShotSampler::get_qubits() const {
+	return this->qubits;
+}
+
+void ShotSampler::analyse_statevector(QuantumBackend* state) {
+	const StateVector& amplitudes = static_cast<StatevectorBackend*>(state)->get_state_vector();
+
+	// Marginal distribution of the measured qubits (outcome k: bit j is qubits[j])
+	std::vector<double> marginal((size_t) 1 << this->qubits.size(), 0);
+	for (size_t index = 0; index < amplitudes.get_size(); index++) {
+		double probability = std::norm(amplitudes.get_amplitude(index));
+		if (probability == 0) continue;
+
+		size_t outcome = 0;
+		for (size_t j = 0; j < this->qubits.size(); j++) {
+			outcome |= ((index >> this->qubits[j]) & 1) << j;
+		}
+		marginal[outcome] += probability;
+	}
+
+	double total = 0;
+	for (size_t outcome = 0; outcome < marginal.size(); outcome++) {
+		if (marginal[outcome] <= 0) continue;
+
+		std::string label(this->qubits.size(), '0');
+		for (size_t j = 0; j < this->qubits.size(); j++) {
+			if ((outcome >> j) & 1) label[j] = '1';
+		}
+		total += marginal[outcome];
+		this->outcomes.push_back(label);
+		this->cumulative.push_back(total);
+	}
+
+	// Rounding errors must not leave shots without outcome
+	if (!this->cumulative.empty()) {
+		for (double& value : this->cumulative) value /= total;
+		this->cumulative.back() = 1;
+	}
+}
+
+void ShotSampler::analyse_stabilizer(QuantumBackend* state) {
+	const StabilizerTableau& tableau = static_cast<StabilizerBackend*>(state)->get_tableau();
+	this->affine = true;
+
+	// Whether an outcome is random does not depend on the earlier outcomes
+	std::vector<int> random_outcomes;
+	StabilizerTableau copy = tableau;
+	this->base_outcome.assign(this->qubits.size(), '0');
+	for (size_t j = 0; j < this->qubits.size(); j++) {
+		if (!copy.is_deterministic(this->qubits[j])) random_outcomes.push_back(j);
+		if (copy.measure(this->qubits[j], 0) == 1) this->base_outcome[j] = '1';
+	}
+
+	// The outcomes that change when one random outcome is 1 instead of 0
+	for (int flipped : random_outcomes) {
+		copy = tableau;
+		std::vector<int> changes;
+		for (size_t j = 0; j < this->qubits.size(); j++) {
+			double random = ((int) j == flipped) ? 0.75 : 0;
+			if (copy.measure(this->qubits[j], random) != this->base_outcome[j] - '0') changes.push_back(j);
+		}
+		this->flips.push_back(changes);
+	}
+}
+
+std::map<std::string, int> ShotSampler::sample(int shots, uint64_t seed, int num_threads,
+		const std::vector<std::vector<uint64_t> >* flips) const {
+	if (num_threads <= 0) {
+		num_threads = std::max(1, (int) std::thread::hardware_concurrency());
+	}
+	int num_blocks = (shots + ShotSampler::BLOCK_SHOTS - 1) / ShotSampler::BLOCK_SHOTS;
+	num_threads = std::max(1, std::min(num_threads, num_blocks));
+
+	// Thread t draws the blocks [t * num_blocks / num_threads, (t + 1) * num_blocks / num_threads),
+	// block k from stream k of the seed, into its own histogram
+	RandomGenerator random(seed);
+	std::vector<std::map<std::string, int> > counts(num_threads);
+	auto draw = [this, shots, num_blocks, num_threads, flips, &random, &counts](int t) {
+		int first_block = (int) ((long long) t * num_blocks / num_threads);
+		int last_block = (int) ((long long) (t + 1) * num_blocks / num_threads);
+		RandomGenerator stream = random.get_stream(first_block);
+		for (int block = first_block; block < last_block; block++) {
+			RandomGenerator block_random = stream;
+			int begin = block * ShotSampler::BLOCK_SHOTS;
+			this->sample_shots(begin, std::min(begin + ShotSampler::BLOCK_SHOTS, shots), block_random, flips, counts[t]);
+			stream.jump();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 1; t < num_threads; t++) {
+		threads.push_back(std::thread(draw, t));
+	}
+	draw(0);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	for (int t = 1; t < num_threads; t++) {
+		for (auto const &entry : counts[t]) {
+			counts[0][entry.first] += entry.second;
+		}
+	}
+	return counts[0];
+}
+
+void ShotSampler::sample_shots(int begin, int end, RandomGenerator& random,
+		const std::vector<std::vector<uint64_t> >* flips, std::map<std::string, int>& counts) const {
+	if (this->affine) {
+		std::string outcome;
+		for (int shot = begin; shot < end; shot++) {
+			outcome = this->base_outcome;
+			for (const std::vector<int>& changes : this->flips) {
+				if (random.next() >> 63) {
+					for (int j : changes) outcome[j] ^= 1;
+				}
+			}
+			if (flips != NULL) ShotSampler::apply_flips(outcome, shot, *flips);
+			counts[outcome]++;
+		}
+	} else if (flips != NULL) {
+		std::string outcome;
+		for (int shot = begin; shot < end; shot++) {
+			double value = random.uniform();
+			size_t k = std::upper_bound(this->cumulative.begin(), this->cumulative.end(), value) - this->cumulative.begin();
+			outcome = this->outcomes[std::min(k, this->outcomes.size() - 1)];
+			ShotSampler::apply_flips(outcome, shot, *flips);
+			counts[outcome]++;
+		}
+	} else {
+		// Shots per outcome first, so the map is only updated once per outcome
+		std::vector<int> hits(this->outcomes.size(), 0);
+		for (int shot = begin; shot < end; shot++) {
+			double value = random.uniform();
+			size_t k = std::upper_bound(this->cumulative.begin(), this->cumulative.end(), value) - this->cumulative.begin();
+			hits[std::min(k, hits.size() - 1)]++;
+		}
+		for (size_t k = 0; k < hits.size(); k++) {
+			if (hits[k] > 0) counts[this->outcomes[k]] += hits[k];
+		}
+	}
+}
+
+void ShotSampler::apply_flips(std::string& outcome, int shot, const std::vector<std::vector<uint64_t> >& flips) {
+	for (size_t j = 0; j < flips.size(); j++) {
+		outcome[j] ^= (flips[j][shot / 64] >> (shot % 64)) & 1;
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef CROSSBAR_SIMULATOR_SHOTSAMPLER_H
+#define CROSSBAR_SIMULATOR_SHOTSAMPLER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "QuantumBackend.h"
+#include "RandomGenerator.h"
+
+/**
+ * Draws measurement shots of some qubits from a final quantum state
+ * without simulating the program again. The state is analysed once:
+ * - statevector: cumulative distribution of the measured qubits, one
+ *   binary search per shot
+ * - stabilizer: the outcomes are an affine function of the random
+ *   outcomes, found by measuring copies of the tableau, so a shot is
+ *   one random bit per random outcome
+ */
+class ShotSampler {
+public:
+	// Shots drawn from the same stream (block k of the shots uses stream k)
+	static const int BLOCK_SHOTS = 4096;
+
+	ShotSampler(QuantumBackend* state, const std::vector<int>& qubits);
+
+	/**
+	 * @param shots
+	 * @param seed the counts only depend on the seed, not on the threads
+	 * @param num_threads 0: one per core
+	 * @param flips optional noise: bit s of flips[k] flips outcome k of shot s
+	 * @return number of shots of every outcome, character k is the
+	 * outcome of qubits[k]
+	 */
+	std::map<std::string, int> sample(int shots, uint64_t seed = 0, int num_threads = 0,
+		const std::vector<std::vector<uint64_t> >* flips = NULL) const;
+
+	const std::vector<int>& get_qubits() const;
+
+private:
+	std::vector<int> qubits;
+
+	// Statevector: outcomes with probability > 0 and cumulative probabilities
+	std::vector<std::string> outcomes;
+	std::vector<double> cumulative;
+
+	// Stabilizer: outcome with every random outcome 0, flipped by each
+	// random outcome that is 1
+	bool affine;
+	std::string base_outcome;
+	std::vector<std::vector<int> > flips;
+
+	void analyse_statevector(QuantumBackend* state);
+	void analyse_stabilizer(QuantumBackend* state);
+	void sample_shots(int begin, int end, RandomGenerator& random,
+		const std::vector<std::vector<uint64_t> >* flips, std::map<std::string, int>& counts) const;
+	static void apply_flips(std::string& outcome, int shot, const std::vector<std::vector<uint64_t> >& flips);
+};
+
+#endif /* CROSSBAR_SIMULATOR_SHOTSAMPLER_H */
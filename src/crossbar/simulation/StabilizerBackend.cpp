@@ -0,0 +1,101 @@
+#include <stdexcept>
+
+#include "StabilizerBackend.h"
+
+StabilizerBackend::StabilizerBackend(int num_qubits) : tableau(num_qubits) {
+
+}
+
+std::string StabilizerBackend::get_name() {
+	return "stabilizer";
+}
+
+QuantumBackend* StabilizerBackend::clone() {
+	return new StabilizerBackend(*this);
+}
+
+int StabilizerBackend::get_num_qubits() {
+	return this->tableau.get_num_qubits();
+}
+
+void StabilizerBackend::set_product_state(const std::vector<std::complex<double> >& alphas,
+		const std::vector<std::complex<double> >& betas) {
+	this->tableau = StabilizerTableau(this->tableau.get_num_qubits());
+	for (int q = 0; q < this->tableau.get_num_qubits(); q++) {
+		if (alphas[q] == 0.0 && std::abs(betas[q]) == 1.0) {
+			this->tableau.x(q);
+		} else if (std::abs(alphas[q]) != 1.0 || betas[q] != 0.0) {
+			throw std::runtime_error(
+				"The stabilizer backend needs qubit " + std::to_string(q) + " in |0> or |1>"
+			);
+		}
+	}
+}
+
+/**
+ * Apply a Clifford one-qubit gate (rotations of multiples of pi/2 are
+ * written with h and s, up to a global phase)
+ */
+void StabilizerBackend::apply_gate(const std::string& gate, int qubit, double angle) {
+	if (gate == "i") {
+		return;
+	} else if (gate == "h") {
+		this->tableau.h(qubit);
+	} else if (gate == "x") {
+		this->tableau.x(qubit);
+	} else if (gate == "y") {
+		this->tableau.y(qubit);
+	} else if (gate == "z") {
+		this->tableau.z(qubit);
+	} else if (gate == "s") {
+		this->tableau.s(qubit);
+	} else if (gate == "sdag") {
+		this->tableau.s(qubit);
+		this->tableau.z(qubit);
+	} else if (gate == "x90") {
+		this->tableau.h(qubit);
+		this->tableau.s(qubit);
+		this->tableau.h(qubit);
+	} else if (gate == "mx90") {
+		this->tableau.h(qubit);
+		this->tableau.s(qubit);
+		this->tableau.z(qubit);
+		this->tableau.h(qubit);
+	} else if (gate == "y90") {
+		this->tableau.z(qubit);
+		this->tableau.h(qubit);
+	} else if (gate == "my90") {
+		this->tableau.h(qubit);
+		this->tableau.z(qubit);
+	} else {
+		throw std::runtime_error("Gate `" + gate + "` is not a Clifford gate");
+	}
+}
+
+void StabilizerBackend::apply_cz(int qubit_a, int qubit_b) {
+	this->tableau.h(qubit_b);
+	this->tableau.cnot(qubit_a, qubit_b);
+	this->tableau.h(qubit_b);
+}
+
+void StabilizerBackend::apply_sqswap(int qubit_a, int qubit_b) {
+	throw std::runtime_error("Gate `sqswap` is not a Clifford gate");
+}
+
+int StabilizerBackend::measure(int qubit, double random) {
+	return this->tableau.measure(qubit, random);
+}
+
+/**
+ * @return 0 or 1 if the outcome is deterministic, 0.5 otherwise
+ */
+double StabilizerBackend::get_probability_one(int qubit) {
+	if (!this->tableau.is_deterministic(qubit)) {
+		return 0.5;
+	}
+	return this->tableau.get_deterministic_outcome(qubit);
+}
+
+const StabilizerTableau& StabilizerBackend::get_tableau() const {
+	return this->tableau;
+}
@@ -0,0 +1,36 @@
+#ifndef CROSSBAR_SIMULATOR_STABILIZERBACKEND_H
+#define CROSSBAR_SIMULATOR_STABILIZERBACKEND_H
+
+#include "QuantumBackend.h"
+#include "StabilizerTableau.h"
+
+/**
+ * Clifford-only simulation in polynomial time and memory (hundreds of
+ * qubits). Supports i, h, x, y, z, s, sdag, x90, mx90, y90, my90, cz and
+ * measurements; the register must start in basis states.
+ */
+class StabilizerBackend : public QuantumBackend {
+public:
+	StabilizerBackend(int num_qubits);
+
+	std::string get_name();
+	QuantumBackend* clone();
+	int get_num_qubits();
+
+	void set_product_state(const std::vector<std::complex<double> >& alphas,
+		const std::vector<std::complex<double> >& betas);
+
+	void apply_gate(const std::string& gate, int qubit, double angle = 0);
+	void apply_cz(int qubit_a, int qubit_b);
+	void apply_sqswap(int qubit_a, int qubit_b);
+
+	int measure(int qubit, double random);
+	double get_probability_one(int qubit);
+
+	const StabilizerTableau& get_tableau() const;
+
+private:
+	StabilizerTableau tableau;
+};
+
+#endif /* CROSSBAR_SIMULATOR_STABILIZERBACKEND_H */
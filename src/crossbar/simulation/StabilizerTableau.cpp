@@ -0,0 +1,222 @@
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+#include "StabilizerTableau.h"
+
+static inline int popcount(uint64_t word) {
+#ifdef __GNUC__
+	return __builtin_popcountll(word);
+#else
+	int count = 0;
+	for (; word != 0; word &= word - 1) count++;
+	return count;
+#endif
+}
+
+/**
+ * Tableau of |00...0>: destabilizer i is X_i and stabilizer i is Z_i
+ * @param num_qubits
+ */
+StabilizerTableau::StabilizerTableau(int num_qubits) {
+	if (num_qubits < 0) {
+		throw std::runtime_error("Invalid number of qubits " + std::to_string(num_qubits));
+	}
+	this->num_qubits = num_qubits;
+	this->words = (num_qubits + 63) / 64;
+
+	int rows = 2 * num_qubits + 1;
+	this->x_bits.assign(rows * this->words, 0);
+	this->z_bits.assign(rows * this->words, 0);
+	this->phases.assign(rows, 0);
+
+	for (int q = 0; q < num_qubits; q++) {
+		this->x_row(q)[q / 64] |= (uint64_t) 1 << (q % 64);
+		this->z_row(q + num_qubits)[q / 64] |= (uint64_t) 1 << (q % 64);
+	}
+}
+
+int StabilizerTableau::get_num_qubits() const {
+	return this->num_qubits;
+}
+
+void StabilizerTableau::h(int qubit) {
+	this->check_qubit(qubit);
+	int word = qubit / 64;
+	uint64_t mask = (uint64_t) 1 << (qubit % 64);
+
+	for (int row = 0; row < 2 * this->num_qubits; row++) {
+		uint64_t& x = this->x_row(row)[word];
+		uint64_t& z = this->z_row(row)[word];
+		if ((x & mask) && (z & mask)) this->phases[row] ^= 1;
+		uint64_t swap = (x ^ z) & mask;
+		x ^= swap;
+		z ^= swap;
+	}
+}
+
+void StabilizerTableau::s(int qubit) {
+	this->check_qubit(qubit);
+	int word = qubit / 64;
+	uint64_t mask = (uint64_t) 1 << (qubit % 64);
+
+	for (int row = 0; row < 2 * this->num_qubits; row++) {
+		uint64_t x = this->x_row(row)[word] & mask;
+		uint64_t& z = this->z_row(row)[word];
+		if (x && (z & mask)) this->phases[row] ^= 1;
+		z ^= x;
+	}
+}
+
+void StabilizerTableau::cnot(int control, int target) {
+	this->check_qubit(control);
+	this->check_qubit(target);
+	int word_c = control / 64, word_t = target / 64;
+	int bit_c = control % 64, bit_t = target % 64;
+
+	for (int row = 0; row < 2 * this->num_qubits; row++) {
+		uint64_t* x = this->x_row(row);
+		uint64_t* z = this->z_row(row);
+		uint64_t x_c = (x[word_c] >> bit_c) & 1, z_c = (z[word_c] >> bit_c) & 1;
+		uint64_t x_t = (x[word_t] >> bit_t) & 1, z_t = (z[word_t] >> bit_t) & 1;
+		if (x_c & z_t & (x_t ^ z_c ^ 1)) this->phases[row] ^= 1;
+		x[word_t] ^= x_c << bit_t;
+		z[word_c] ^= z_t << bit_c;
+	}
+}
+
+void StabilizerTableau::x(int qubit) {
+	this->check_qubit(qubit);
+	uint64_t mask = (uint64_t) 1 << (qubit % 64);
+	for (int row = 0; row < 2 * this->num_qubits; row++) {
+		if (this->z_row(row)[qubit / 64] & mask) this->phases[row] ^= 1;
+	}
+}
+
+void StabilizerTableau::y(int qubit) {
+	this->check_qubit(qubit);
+	uint64_t mask = (uint64_t) 1 << (qubit % 64);
+	for (int row = 0; row < 2 * this->num_qubits; row++) {
+		if ((this->x_row(row)[qubit / 64] ^ this->z_row(row)[qubit / 64]) & mask) this->phases[row] ^= 1;
+	}
+}
+
+void StabilizerTableau::z(int qubit) {
+	this->check_qubit(qubit);
+	uint64_t mask = (uint64_t) 1 << (qubit % 64);
+	for (int row = 0; row < 2 * this->num_qubits; row++) {
+		if (this->x_row(row)[qubit / 64] & mask) this->phases[row] ^= 1;
+	}
+}
+
+/**
+ * Measure a qubit in the Z basis and update the tableau
+ * @param qubit
+ * @param random uniform number in [0, 1) (only used if the outcome is random)
+ * @return 0 or 1
+ */
+int StabilizerTableau::measure(int qubit, double random) {
+	this->check_qubit(qubit);
+	int n = this->num_qubits;
+	int word = qubit / 64;
+	uint64_t mask = (uint64_t) 1 << (qubit % 64);
+
+	// A stabilizer that anticommutes with Z makes the outcome random
+	int pivot = -1;
+	for (int row = n; row < 2 * n && pivot < 0; row++) {
+		if (this->x_row(row)[word] & mask) pivot = row;
+	}
+	if (pivot < 0) {
+		return this->get_deterministic_outcome(qubit);
+	}
+
+	for (int row = 0; row < 2 * n; row++) {
+		if (row != pivot && (this->x_row(row)[word] & mask)) {
+			this->multiply_row(row, pivot);
+		}
+	}
+
+	// The destabilizer takes the old stabilizer, which becomes +-Z
+	std::copy(this->x_row(pivot), this->x_row(pivot) + this->words, this->x_row(pivot - n));
+	std::copy(this->z_row(pivot), this->z_row(pivot) + this->words, this->z_row(pivot - n));
+	this->phases[pivot - n] = this->phases[pivot];
+
+	int outcome = (random < 0.5) ? 0 : 1;
+	std::fill(this->x_row(pivot), this->x_row(pivot) + this->words, 0);
+	std::fill(this->z_row(pivot), this->z_row(pivot) + this->words, 0);
+	this->z_row(pivot)[word] = mask;
+	this->phases[pivot] = outcome;
+	return outcome;
+}
+
+/**
+ * @return true if measuring the qubit gives always the same outcome
+ */
+bool StabilizerTableau::is_deterministic(int qubit) const {
+	this->check_qubit(qubit);
+	uint64_t mask = (uint64_t) 1 << (qubit % 64);
+	for (int row = this->num_qubits; row < 2 * this->num_qubits; row++) {
+		if (this->x_row(row)[qubit / 64] & mask) return false;
+	}
+	return true;
+}
+
+/**
+ * Outcome of measuring a qubit with a deterministic outcome (the product
+ * of the stabilizers that give +-Z on it)
+ */
+int StabilizerTableau::get_deterministic_outcome(int qubit) const {
+	this->check_qubit(qubit);
+	int n = this->num_qubits;
+	uint64_t mask = (uint64_t) 1 << (qubit % 64);
+
+	std::vector<uint64_t> x(this->words, 0);
+	std::vector<uint64_t> z(this->words, 0);
+	uint8_t phase = 0;
+	for (int row = 0; row < n; row++) {
+		if (this->x_row(row)[qubit / 64] & mask) {
+			phase = StabilizerTableau::multiply(x.data(), z.data(), phase,
+				this->x_row(row + n), this->z_row(row + n), this->phases[row + n], this->words);
+		}
+	}
+	return phase;
+}
+
+/**
+ * Row target = row source * row target
+ */
+void StabilizerTableau::multiply_row(int target, int source) {
+	this->phases[target] = StabilizerTableau::multiply(
+		this->x_row(target), this->z_row(target), this->phases[target],
+		this->x_row(source), this->z_row(source), this->phases[source], this->words);
+}
+
+/**
+ * Multiply a Pauli string into another one, 64 qubits per step. The
+ * exponent of i of the product is counted with the bits of the qubits
+ * that contribute +i and -i.
+ * @return phase of the product (0: +, 1: -)
+ */
+uint8_t StabilizerTableau::multiply(uint64_t* target_x, uint64_t* target_z, uint8_t target_phase,
+		const uint64_t* source_x, const uint64_t* source_z, uint8_t source_phase, int words) {
+	int exponent = 2 * target_phase + 2 * source_phase;
+	for (int w = 0; w < words; w++) {
+		uint64_t x1 = source_x[w], z1 = source_z[w];
+		uint64_t x2 = target_x[w], z2 = target_z[w];
+
+		// Y * Z, X * Y, Z * X give +i; the reverse gives -i
+		uint64_t plus = (x1 & z1 & z2 & ~x2) | (x1 & ~z1 & x2 & z2) | (~x1 & z1 & x2 & ~z2);
+		uint64_t minus = (x1 & z1 & x2 & ~z2) | (x1 & ~z1 & z2 & ~x2) | (~x1 & z1 & x2 & z2);
+		exponent += popcount(plus) - popcount(minus);
+
+		target_x[w] = x2 ^ x1;
+		target_z[w] = z2 ^ z1;
+	}
+	return (((exponent % 4) + 4) % 4 == 2) ? 1 : 0;
+}
+
+void StabilizerTableau::check_qubit(int qubit) const {
+	if (qubit < 0 || qubit >= this->num_qubits) {
+		throw std::runtime_error("Qubit " + std::to_string(qubit) + " is not in the tableau");
+	}
+}
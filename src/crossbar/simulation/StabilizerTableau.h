@@ -0,0 +1,54 @@
+#ifndef CROSSBAR_SIMULATOR_STABILIZERTABLEAU_H
+#define CROSSBAR_SIMULATOR_STABILIZERTABLEAU_H
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Stabilizer state of n qubits (Aaronson-Gottesman CHP tableau). Rows
+ * 0..n-1 are the destabilizers, n..2n-1 the stabilizers and 2n is
+ * scratch. The X and Z bits of a row are packed in 64-bit words, so
+ * multiplying two rows costs n / 64 word operations.
+ */
+class StabilizerTableau {
+public:
+	StabilizerTableau(int num_qubits);
+
+	int get_num_qubits() const;
+
+	// Clifford generators
+	void h(int qubit);
+	void s(int qubit);
+	void cnot(int control, int target);
+
+	// Paulis (phase only)
+	void x(int qubit);
+	void y(int qubit);
+	void z(int qubit);
+
+	// Z basis (random in [0, 1))
+	int measure(int qubit, double random);
+	bool is_deterministic(int qubit) const;
+	int get_deterministic_outcome(int qubit) const;
+
+private:
+	int num_qubits;
+	int words;
+
+	// Row i: X bits at [i * words, (i + 1) * words), same for Z
+	std::vector<uint64_t> x_bits;
+	std::vector<uint64_t> z_bits;
+	std::vector<uint8_t> phases;
+
+	uint64_t* x_row(int row) { return &this->x_bits[row * this->words]; }
+	uint64_t* z_row(int row) { return &this->z_bits[row * this->words]; }
+	const uint64_t* x_row(int row) const { return &this->x_bits[row * this->words]; }
+	const uint64_t* z_row(int row) const { return &this->z_bits[row * this->words]; }
+
+	void multiply_row(int target, int source);
+	static uint8_t multiply(uint64_t* target_x, uint64_t* target_z, uint8_t target_phase,
+		const uint64_t* source_x, const uint64_t* source_z, uint8_t source_phase, int words);
+	void check_qubit(int qubit) const;
+};
+
+#endif /* CROSSBAR_SIMULATOR_STABILIZERTABLEAU_H */
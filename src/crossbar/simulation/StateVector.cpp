@@ -0,0 +1,318 @@
+#include <cmath>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "StateVector.h"
+
+#ifdef __SSE2__
+/**
+ * Complex product of a = [re, im] and b, with b given as
+ * b_re = [re, re] and b_im = [-im, im]
+ */
+static inline __m128d complex_mul(__m128d a, __m128d b_re, __m128d b_im) {
+	__m128d swapped = _mm_shuffle_pd(a, a, 1);
+	return _mm_add_pd(_mm_mul_pd(a, b_re), _mm_mul_pd(swapped, b_im));
+}
+#endif
+
+/**
+ * Visit the amplitude pairs (k, k + stride) numbered [begin, end) as
+ * runs of consecutive k, so the range is read as (at most) two
+ * contiguous streams
+ * @param body called with the first and last (excluded) k of each run
+ */
+template <typename Body>
+static inline void for_pairs(size_t stride, size_t begin, size_t end, Body body) {
+	while (begin < end) {
+		size_t offset = begin & (stride - 1);
+		size_t run = std::min(stride - offset, end - begin);
+		size_t k = ((begin - offset) << 1) + offset;
+		body(k, k + run);
+		begin += run;
+	}
+}
+
+/**
+ * Index with a zero inserted at the given bit
+ */
+static inline size_t insert_zero_bit(size_t index, int bit) {
+	size_t low = index & (((size_t) 1 << bit) - 1);
+	return ((index - low) << 1) | low;
+}
+
+/**
+ * Register in |00...0>
+ * @param num_qubits
+ */
+StateVector::StateVector(int num_qubits) {
+	if (num_qubits < 0 || num_qubits > StateVector::MAX_QUBITS) {
+		throw std::runtime_error(
+			"Can not simulate " + std::to_string(num_qubits)
+			+ " qubits (maximum " + std::to_string(StateVector::MAX_QUBITS) + ")"
+		);
+	}
+	this->num_qubits = num_qubits;
+	this->amplitudes.assign((size_t) 1 << num_qubits, 0);
+	this->amplitudes[0] = 1;
+	this->set_num_threads(0);
+}
+
+/**
+ * Set the register to the product of one-qubit states
+ * @param alphas amplitude of |0> of every qubit
+ * @param betas amplitude of |1> of every qubit
+ */
+void StateVector::set_product_state(const std::vector<std::complex<double> >& alphas,
+		const std::vector<std::complex<double> >& betas) {
+	this->amplitudes.assign(this->amplitudes.size(), 0);
+	this->amplitudes[0] = 1;
+
+	// Qubit q doubles the filled part of the vector
+	for (int q = 0; q < this->num_qubits; q++) {
+		size_t half = (size_t) 1 << q;
+		for (size_t k = 0; k < half; k++) {
+			this->amplitudes[k + half] = this->amplitudes[k] * betas[q];
+			this->amplitudes[k] *= alphas[q];
+		}
+	}
+}
+
+int StateVector::get_num_threads() const {
+	return this->num_threads;
+}
+
+/**
+ * @param num_threads threads of the kernels (0: one per core)
+ */
+void StateVector::set_num_threads(int num_threads) {
+	if (num_threads <= 0) {
+		num_threads = std::max(1, (int) std::thread::hardware_concurrency());
+	}
+	this->num_threads = num_threads;
+
+	if (num_threads > 1 && this->amplitudes.size() >= StateVector::PARALLEL_MIN_SIZE) {
+		this->workers = std::make_shared<WorkerPool>(num_threads - 1);
+	} else {
+		this->workers = nullptr;
+	}
+}
+
+int StateVector::get_num_qubits() const {
+	return this->num_qubits;
+}
+
+size_t StateVector::get_size() const {
+	return this->amplitudes.size();
+}
+
+const std::complex<double>& StateVector::get_amplitude(size_t index) const {
+	return this->amplitudes.at(index);
+}
+
+/**
+ * Probability of measuring |1> on a qubit
+ */
+double StateVector::get_probability_one(int qubit) const {
+	this->check_qubit(qubit);
+	size_t stride = (size_t) 1 << qubit;
+	const std::complex<double>* data = this->amplitudes.data();
+
+	size_t count = this->amplitudes.size() / 2;
+	std::vector<double> partials((count + StateVector::BLOCK_SIZE - 1) / StateVector::BLOCK_SIZE, 0);
+	this->parallel_for(count, [&](size_t begin, size_t end) {
+		for (size_t block = begin; block < end; block += StateVector::BLOCK_SIZE) {
+			double sum = 0;
+			for_pairs(stride, block, std::min(block + StateVector::BLOCK_SIZE, end), [&](size_t first, size_t last) {
+				for (size_t k = first; k < last; k++) {
+					sum += std::norm(data[k + stride]);
+				}
+			});
+			partials[block / StateVector::BLOCK_SIZE] = sum;
+		}
+	});
+
+	double probability = 0;
+	for (double sum : partials) {
+		probability += sum;
+	}
+	return probability;
+}
+
+/**
+ * Apply a one-qubit gate. Every amplitude pair (k, k + 2^qubit) is
+ * multiplied by the matrix, one complex number per SSE2 register.
+ */
+void StateVector::apply(const GateMatrix& gate, int qubit) {
+	this->check_qubit(qubit);
+	if (gate.is_identity()) {
+		return;
+	} else if (gate.is_diagonal()) {
+		this->apply_diagonal(gate.get(0, 0), gate.get(1, 1), qubit);
+		return;
+	}
+
+	size_t stride = (size_t) 1 << qubit;
+
+#ifdef __SSE2__
+	double* data = reinterpret_cast<double*>(this->amplitudes.data());
+	__m128d re[4], im[4];
+	for (int e = 0; e < 4; e++) {
+		const std::complex<double>& value = gate.get(e / 2, e % 2);
+		re[e] = _mm_set1_pd(value.real());
+		im[e] = _mm_set_pd(value.imag(), -value.imag());
+	}
+
+	this->parallel_for(this->amplitudes.size() / 2, [&](size_t begin, size_t end) {
+		for_pairs(stride, begin, end, [&](size_t first, size_t last) {
+			for (size_t k = first; k < last; k++) {
+				double* low = data + 2 * k;
+				double* high = data + 2 * (k + stride);
+				__m128d a0 = _mm_loadu_pd(low);
+				__m128d a1 = _mm_loadu_pd(high);
+				_mm_storeu_pd(low, _mm_add_pd(complex_mul(a0, re[0], im[0]), complex_mul(a1, re[1], im[1])));
+				_mm_storeu_pd(high, _mm_add_pd(complex_mul(a0, re[2], im[2]), complex_mul(a1, re[3], im[3])));
+			}
+		});
+	});
+#else
+	std::complex<double>* data = this->amplitudes.data();
+	std::complex<double> m00 = gate.get(0, 0), m01 = gate.get(0, 1);
+	std::complex<double> m10 = gate.get(1, 0), m11 = gate.get(1, 1);
+	this->parallel_for(this->amplitudes.size() / 2, [&](size_t begin, size_t end) {
+		for_pairs(stride, begin, end, [&](size_t first, size_t last) {
+			for (size_t k = first; k < last; k++) {
+				std::complex<double> a0 = data[k];
+				std::complex<double> a1 = data[k + stride];
+				data[k] = m00 * a0 + m01 * a1;
+				data[k + stride] = m10 * a0 + m11 * a1;
+			}
+		});
+	});
+#endif
+}
+
+/**
+ * Multiply by a phase the amplitudes where both qubits are |1> (CZ for -1)
+ */
+void StateVector::apply_controlled_phase(int qubit_a, int qubit_b, std::complex<double> phase) {
+	this->check_qubit(qubit_a);
+	this->check_qubit(qubit_b);
+	int low_bit = std::min(qubit_a, qubit_b);
+	int high_bit = std::max(qubit_a, qubit_b);
+	size_t mask = ((size_t) 1 << qubit_a) | ((size_t) 1 << qubit_b);
+	std::complex<double>* data = this->amplitudes.data();
+
+	this->parallel_for(this->amplitudes.size() / 4, [&](size_t begin, size_t end) {
+		for (size_t r = begin; r < end; r++) {
+			data[insert_zero_bit(insert_zero_bit(r, low_bit), high_bit) | mask] *= phase;
+		}
+	});
+}
+
+/**
+ * Square root of SWAP: mixes |01> and |10>, keeps |00> and |11>
+ */
+void StateVector::apply_sqswap(int qubit_a, int qubit_b) {
+	this->check_qubit(qubit_a);
+	this->check_qubit(qubit_b);
+	int low_bit = std::min(qubit_a, qubit_b);
+	int high_bit = std::max(qubit_a, qubit_b);
+	size_t bit_a = (size_t) 1 << qubit_a;
+	size_t bit_b = (size_t) 1 << qubit_b;
+	std::complex<double>* data = this->amplitudes.data();
+
+	const std::complex<double> same(0.5, 0.5);
+	const std::complex<double> cross(0.5, -0.5);
+	this->parallel_for(this->amplitudes.size() / 4, [&](size_t begin, size_t end) {
+		for (size_t r = begin; r < end; r++) {
+			size_t base = insert_zero_bit(insert_zero_bit(r, low_bit), high_bit);
+			std::complex<double> a = data[base | bit_a];
+			std::complex<double> b = data[base | bit_b];
+			data[base | bit_a] = same * a + cross * b;
+			data[base | bit_b] = cross * a + same * b;
+		}
+	});
+}
+
+/**
+ * Measure a qubit in the Z basis and collapse the register
+ * @param qubit
+ * @param random uniform number in [0, 1)
+ * @return 0 or 1
+ */
+int StateVector::measure(int qubit, double random) {
+	double probability_one = this->get_probability_one(qubit);
+	int outcome = (random < 1 - probability_one) ? 0 : 1;
+	double probability = outcome ? probability_one : 1 - probability_one;
+	double scale = (probability > 0) ? 1 / std::sqrt(probability) : 0;
+
+	if (outcome) {
+		this->apply_diagonal(0, scale, qubit);
+	} else {
+		this->apply_diagonal(scale, 0, qubit);
+	}
+	return outcome;
+}
+
+/**
+ * Prepare a qubit in |0> (measure and flip)
+ */
+void StateVector::reset(int qubit, double random) {
+	if (this->measure(qubit, random) == 1) {
+		this->apply(GateMatrix::from_name("x"), qubit);
+	}
+}
+
+/**
+ * Split [0, count) in one contiguous range per thread, starting at
+ * multiples of BLOCK_SIZE. The calling thread takes the first range.
+ */
+void StateVector::parallel_for(size_t count, const std::function<void(size_t, size_t)>& body) const {
+	if (this->workers == nullptr || count * 2 < StateVector::PARALLEL_MIN_SIZE) {
+		body(0, count);
+		return;
+	}
+
+	size_t chunk = (count + this->num_threads - 1) / this->num_threads;
+	chunk = (chunk + StateVector::BLOCK_SIZE - 1) / StateVector::BLOCK_SIZE * StateVector::BLOCK_SIZE;
+	this->workers->run([&](int t) {
+		size_t begin = t * chunk;
+		if (begin < count) {
+			body(begin, std::min(begin + chunk, count));
+		}
+	}, this->num_threads);
+}
+
+void StateVector::apply_diagonal(std::complex<double> d0, std::complex<double> d1, int qubit) {
+	size_t stride = (size_t) 1 << qubit;
+	std::complex<double>* data = this->amplitudes.data();
+	bool scale_low = (d0 != 1.0);
+	bool scale_high = (d1 != 1.0);
+
+	this->parallel_for(this->amplitudes.size() / 2, [&](size_t begin, size_t end) {
+		for_pairs(stride, begin, end, [&](size_t first, size_t last) {
+			if (scale_low) {
+				for (size_t k = first; k < last; k++) {
+					data[k] *= d0;
+				}
+			}
+			if (scale_high) {
+				for (size_t k = first + stride; k < last + stride; k++) {
+					data[k] *= d1;
+				}
+			}
+		});
+	});
+}
+
+void StateVector::check_qubit(int qubit) const {
+	if (qubit < 0 || qubit >= this->num_qubits) {
+		throw std::runtime_error("Qubit " + std::to_string(qubit) + " is not in the register");
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef CROSSBAR_SIMULATOR_STATEVECTOR_H
+#define CROSSBAR_SIMULATOR_STATEVECTOR_H
+
+#include <vector>
+#include <complex>
+#include <memory>
+#include <functional>
+#include <stddef.h>
+
+#include "GateMatrix.h"
+#include "WorkerPool.h"
+
+/**
+ * Amplitudes of a register of qubits. Qubit q is bit q of the index of
+ * the amplitude, so the amplitude of |q1 q0> = |10> is at index 2.
+ * Large registers are updated by several threads.
+ */
+class StateVector {
+public:
+	static const int MAX_QUBITS = 30;
+
+	// Smaller registers are updated by the calling thread only
+	static const size_t PARALLEL_MIN_SIZE = (size_t) 1 << 16;
+
+	// The ranges of the threads start at multiples of this many pairs, and
+	// sums add one partial per block in order (same result with any threads)
+	static const size_t BLOCK_SIZE = (size_t) 1 << 12;
+
+	StateVector(int num_qubits);
+
+	void set_product_state(const std::vector<std::complex<double> >& alphas,
+		const std::vector<std::complex<double> >& betas);
+
+	int get_num_threads() const;
+	void set_num_threads(int num_threads);
+
+	int get_num_qubits() const;
+	size_t get_size() const;
+	const std::complex<double>& get_amplitude(size_t index) const;
+	double get_probability_one(int qubit) const;
+
+	// Gates
+	void apply(const GateMatrix& gate, int qubit);
+	void apply_controlled_phase(int qubit_a, int qubit_b, std::complex<double> phase);
+	void apply_sqswap(int qubit_a, int qubit_b);
+
+	// Collapse (random in [0, 1))
+	int measure(int qubit, double random);
+	void reset(int qubit, double random);
+
+private:
+	int num_qubits;
+	int num_threads;
+	std::vector<std::complex<double> > amplitudes;
+
+	// Started once for large registers (shared by the copies)
+	std::shared_ptr<WorkerPool> workers;
+
+	void parallel_for(size_t count, const std::function<void(size_t, size_t)>& body) const;
+
+	void apply_diagonal(std::complex<double> d0, std::complex<double> d1, int qubit);
+	void check_qubit(int qubit) const;
+};
+
+#endif /* CROSSBAR_SIMULATOR_STATEVECTOR_H */
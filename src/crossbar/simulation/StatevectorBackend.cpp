@@ -0,0 +1,81 @@
+#include "StatevectorBackend.h"
+
+StatevectorBackend::StatevectorBackend(int num_qubits, int num_threads) : state(num_qubits) {
+	this->state.set_num_threads(num_threads);
+}
+
+std::string StatevectorBackend::get_name() {
+	return "statevector";
+}
+
+QuantumBackend* StatevectorBackend::clone() {
+	return new StatevectorBackend(*this);
+}
+
+int StatevectorBackend::get_num_qubits() {
+	return this->state.get_num_qubits();
+}
+
+void StatevectorBackend::set_product_state(const std::vector<std::complex<double> >& alphas,
+		const std::vector<std::complex<double> >& betas) {
+	this->pending_gates.clear();
+	this->state.set_product_state(alphas, betas);
+}
+
+void StatevectorBackend::apply_gate(const std::string& gate, int qubit, double angle) {
+	GateMatrix& pending = this->pending_gates[qubit];
+	pending = GateMatrix::from_name(gate, angle) * pending;
+}
+
+void StatevectorBackend::apply_cz(int qubit_a, int qubit_b) {
+	this->flush(qubit_a);
+	this->flush(qubit_b);
+	this->state.apply_controlled_phase(qubit_a, qubit_b, -1);
+}
+
+void StatevectorBackend::apply_sqswap(int qubit_a, int qubit_b) {
+	this->flush(qubit_a);
+	this->flush(qubit_b);
+	this->state.apply_sqswap(qubit_a, qubit_b);
+}
+
+int StatevectorBackend::measure(int qubit, double random) {
+	this->flush(qubit);
+	return this->state.measure(qubit, random);
+}
+
+double StatevectorBackend::get_probability_one(int qubit) {
+	this->flush(qubit);
+	return this->state.get_probability_one(qubit);
+}
+
+/**
+ * Apply all the pending one-qubit gates
+ */
+void StatevectorBackend::flush() {
+	while (!this->pending_gates.empty()) {
+		this->flush(this->pending_gates.begin()->first);
+	}
+}
+
+bool StatevectorBackend::has_pending_gates(int qubit) const {
+	if (qubit < 0) return !this->pending_gates.empty();
+	return this->pending_gates.count(qubit) > 0;
+}
+
+/**
+ * @return amplitudes with all the gates applied
+ */
+const StateVector& StatevectorBackend::get_state_vector() {
+	this->flush();
+	return this->state;
+}
+
+void StatevectorBackend::flush(int qubit) {
+	auto it = this->pending_gates.find(qubit);
+	if (it == this->pending_gates.end()) return;
+
+	GateMatrix gate = it->second;
+	this->pending_gates.erase(it);
+	this->state.apply(gate, qubit);
+}
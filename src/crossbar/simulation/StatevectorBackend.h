@@ -0,0 +1,45 @@
+#ifndef CROSSBAR_SIMULATOR_STATEVECTORBACKEND_H
+#define CROSSBAR_SIMULATOR_STATEVECTORBACKEND_H
+
+#include <map>
+
+#include "QuantumBackend.h"
+#include "StateVector.h"
+#include "GateMatrix.h"
+
+/**
+ * Full amplitudes (any gate, up to StateVector::MAX_QUBITS qubits).
+ * Consecutive one-qubit gates on the same qubit are multiplied together
+ * and applied in one pass when the qubit is next used by another gate.
+ */
+class StatevectorBackend : public QuantumBackend {
+public:
+	StatevectorBackend(int num_qubits, int num_threads = 0);
+
+	std::string get_name();
+	QuantumBackend* clone();
+	int get_num_qubits();
+
+	void set_product_state(const std::vector<std::complex<double> >& alphas,
+		const std::vector<std::complex<double> >& betas);
+
+	void apply_gate(const std::string& gate, int qubit, double angle = 0);
+	void apply_cz(int qubit_a, int qubit_b);
+	void apply_sqswap(int qubit_a, int qubit_b);
+
+	int measure(int qubit, double random);
+	double get_probability_one(int qubit);
+
+	void flush();
+	bool has_pending_gates(int qubit = -1) const;
+
+	const StateVector& get_state_vector();
+
+private:
+	StateVector state;
+	std::map<int, GateMatrix> pending_gates;
+
+	void flush(int qubit);
+};
+
+#endif /* CROSSBAR_SIMULATOR_STATEVECTORBACKEND_H */
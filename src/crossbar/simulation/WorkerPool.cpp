@@ -0,0 +1,90 @@
+#include <algorithm>
+
+#include "WorkerPool.h"
+
+/**
+ * Start the workers
+ * @param num_workers threads besides the calling one
+ */
+WorkerPool::WorkerPool(int num_workers) {
+	this->task = nullptr;
+	this->num_tasks = 0;
+	this->remaining = 0;
+	this->generation = 0;
+	this->stopping = false;
+
+	for (int w = 0; w < num_workers; w++) {
+		this->workers.push_back(std::thread(&WorkerPool::work, this, w));
+	}
+}
+
+/**
+ * Stop and join the workers
+ */
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->start_condition.notify_all();
+
+	for (std::thread& worker : this->workers) {
+		worker.join();
+	}
+}
+
+int WorkerPool::get_num_workers() const {
+	return this->workers.size();
+}
+
+void WorkerPool::run(const std::function<void(int)>& task, int num_tasks) {
+	std::lock_guard<std::mutex> run_lock(this->run_mutex);
+
+	// Workers without a task do not take part in the run
+	int num_workers = std::min((int) this->workers.size(), num_tasks - 1);
+	if (num_workers > 0) {
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->task = &task;
+		this->num_tasks = num_tasks;
+		this->remaining = num_workers;
+		this->generation++;
+	}
+	if (num_workers > 0) {
+		this->start_condition.notify_all();
+	}
+
+	if (num_tasks > 0) {
+		task(0);
+	}
+
+	if (num_workers > 0) {
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->done_condition.wait(lock, [this]() { return this->remaining == 0; });
+		this->task = nullptr;
+	}
+}
+
+void WorkerPool::work(int index) {
+	unsigned long seen_generation = 0;
+	while (true) {
+		const std::function<void(int)>* task;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->start_condition.wait(lock, [&]() {
+				return this->stopping || this->generation != seen_generation;
+			});
+			if (this->stopping) return;
+
+			seen_generation = this->generation;
+			if (index + 1 >= this->num_tasks) continue;
+			task = this->task;
+		}
+
+		(*task)(index + 1);
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (--this->remaining == 0) {
+			this->done_condition.notify_one();
+		}
+	}
+}
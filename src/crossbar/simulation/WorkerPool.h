@@ -0,0 +1,45 @@
+#ifndef CROSSBAR_SIMULATOR_WORKERPOOL_H
+#define CROSSBAR_SIMULATOR_WORKERPOOL_H
+
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * Threads that are started once and wait for tasks, so the kernels do not
+ * create and join threads on every call. One run at a time: concurrent
+ * callers wait for their turn.
+ */
+class WorkerPool {
+public:
+	WorkerPool(int num_workers);
+	~WorkerPool();
+
+	int get_num_workers() const;
+
+	// Call task(t) for t in [0, num_tasks): the calling thread does task 0
+	// and worker w does task w + 1
+	void run(const std::function<void(int)>& task, int num_tasks);
+
+private:
+	std::vector<std::thread> workers;
+
+	// Serializes the runs
+	std::mutex run_mutex;
+
+	// State of the current run
+	std::mutex mutex;
+	std::condition_variable start_condition;
+	std::condition_variable done_condition;
+	const std::function<void(int)>* task;
+	int num_tasks;
+	int remaining;
+	unsigned long generation;
+	bool stopping;
+
+	void work(int index);
+};
+
+#endif /* CROSSBAR_SIMULATOR_WORKERPOOL_H */
@@ -0,0 +1,16 @@
+#include "AutoBackend.h"
+#include "crossbar/CrossbarModel.h"
+
+AutoBackend::AutoBackend() : solver(CrossbarModel::MAX_QL_VOLTAGE) {
+	
+}
+
+std::string AutoBackend::get_name() {
+	return "auto";
+}
+
+void AutoBackend::solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution) {
+	if (!this->solver.solve(constraints, solution)) {
+		this->fallback.solve(constraints, solution);
+	}
+}
@@ -0,0 +1,24 @@
+#ifndef CROSSBAR_SIMULATOR_AUTOBACKEND_H
+#define CROSSBAR_SIMULATOR_AUTOBACKEND_H
+
+#include "ConstraintBackend.h"
+#include "DifferenceSolver.h"
+#include "NaxosBackend.h"
+
+/**
+ * Backend that tries the difference-constraint solver first and falls
+ * back to naxos when it can not solve the constraints
+ */
+class AutoBackend : public ConstraintBackend {
+public:
+	AutoBackend();
+	
+	std::string get_name();
+	void solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution);
+	
+private:
+	DifferenceSolver solver;
+	NaxosBackend fallback;
+};
+
+#endif /* CROSSBAR_SIMULATOR_AUTOBACKEND_H */
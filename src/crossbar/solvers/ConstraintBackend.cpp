@@ -0,0 +1,27 @@
+#include <stdexcept>
+
+#include "ConstraintBackend.h"
+#include "NaxosBackend.h"
+#include "DifferenceBackend.h"
+#include "AutoBackend.h"
+
+/**
+ * Create a backend by name
+ * @param name "naxos", "difference" or "auto"
+ * @return new backend
+ */
+ConstraintBackend* ConstraintBackend::create(const std::string& name) {
+	if (name == "naxos") {
+		return new NaxosBackend();
+	} else if (name == "difference") {
+		return new DifferenceBackend();
+	} else if (name == "auto") {
+		return new AutoBackend();
+	}
+	
+	throw std::runtime_error("Unknown constraint backend '" + name + "'");
+}
+
+std::vector<std::string> ConstraintBackend::get_names() {
+	return {"naxos", "difference", "auto"};
+}
@@ -0,0 +1,30 @@
+#ifndef CROSSBAR_SIMULATOR_CONSTRAINTBACKEND_H
+#define CROSSBAR_SIMULATOR_CONSTRAINTBACKEND_H
+
+#include <string>
+#include <vector>
+
+#include "crossbar/LineConstraint.h"
+#include "crossbar/CrossbarSolution.h"
+
+/**
+ * Solver of the constraints of one cycle. The variables are the control
+ * lines, sites and wave; the objective is the lowest sum of the lines.
+ */
+class ConstraintBackend {
+public:
+	virtual ~ConstraintBackend() {}
+	
+	virtual std::string get_name() = 0;
+	
+	/**
+	 * Store the best values of the constrained lines in the solution
+	 * @throws std::runtime_error if the constraints are in conflict
+	 */
+	virtual void solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution) = 0;
+	
+	static ConstraintBackend* create(const std::string& name);
+	static std::vector<std::string> get_names();
+};
+
+#endif /* CROSSBAR_SIMULATOR_CONSTRAINTBACKEND_H */
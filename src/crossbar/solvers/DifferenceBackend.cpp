@@ -0,0 +1,22 @@
+#include <stdexcept>
+
+#include "DifferenceBackend.h"
+#include "crossbar/CrossbarModel.h"
+
+DifferenceBackend::DifferenceBackend() : solver(CrossbarModel::MAX_QL_VOLTAGE) {
+	
+}
+
+std::string DifferenceBackend::get_name() {
+	return "difference";
+}
+
+/**
+ * The constraints of the operations are all difference constraints, so a
+ * cycle in the inequalities or a broken bound means there is no solution
+ */
+void DifferenceBackend::solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution) {
+	if (!this->solver.solve(constraints, solution)) {
+		throw std::runtime_error("Conflict between parallel operations");
+	}
+}
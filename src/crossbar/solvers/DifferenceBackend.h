@@ -0,0 +1,21 @@
+#ifndef CROSSBAR_SIMULATOR_DIFFERENCEBACKEND_H
+#define CROSSBAR_SIMULATOR_DIFFERENCEBACKEND_H
+
+#include "ConstraintBackend.h"
+#include "DifferenceSolver.h"
+
+/**
+ * Backend that only uses the difference-constraint solver
+ */
+class DifferenceBackend : public ConstraintBackend {
+public:
+	DifferenceBackend();
+	
+	std::string get_name();
+	void solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution);
+	
+private:
+	DifferenceSolver solver;
+};
+
+#endif /* CROSSBAR_SIMULATOR_DIFFERENCEBACKEND_H */
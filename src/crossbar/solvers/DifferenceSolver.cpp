@@ -0,0 +1,174 @@
+#include "DifferenceSolver.h"
+
+#include <climits>
+#include <algorithm>
+
+DifferenceSolver::DifferenceSolver(long max_d_value) {
+	this->max_d_value = max_d_value;
+}
+
+/**
+ * Get the lowest values that satisfy the constraints.
+ * @param constraints
+ * @param solution where the values of the lines are stored
+ * @return false if the constraints are not difference constraints, have
+ * a cycle or are in conflict (the caller must fall back to the CSP solver)
+ */
+bool DifferenceSolver::solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution) {
+	this->variables.clear();
+	this->parents.clear();
+	this->lower.clear();
+	this->upper.clear();
+	
+	// 1. Merge the variables that must be equal
+	for (const LineConstraint& constraint : constraints) {
+		int a = this->get_variable(constraint.get_type(), constraint.get_index());
+		if (constraint.is_binary()) {
+			int b = this->get_variable(constraint.get_other_type(), constraint.get_other_index());
+			if (constraint.get_relation() == LineConstraint::EQUAL) {
+				a = this->find(a);
+				b = this->find(b);
+				if (a != b) {
+					this->parents[b] = a;
+					this->lower[a] = std::max(this->lower[a], this->lower[b]);
+					this->upper[a] = std::min(this->upper[a], this->upper[b]);
+				}
+			}
+		}
+	}
+	
+	// 2. Bounds and strict inequalities (b > a is stored as the edge a -> b)
+	int size = this->parents.size();
+	this->successors.assign(size, {});
+	std::vector<int> in_degree(size, 0);
+	for (const LineConstraint& constraint : constraints) {
+		int a = this->find(this->get_variable(constraint.get_type(), constraint.get_index()));
+		
+		if (constraint.is_binary()) {
+			int b = this->find(this->get_variable(constraint.get_other_type(), constraint.get_other_index()));
+			if (constraint.get_relation() == LineConstraint::EQUAL) {
+				continue;
+			}
+			if (a == b) {
+				return false;
+			}
+			if (constraint.get_relation() == LineConstraint::LESS) {
+				this->successors[a].push_back(b);
+				in_degree[b]++;
+			} else {
+				this->successors[b].push_back(a);
+				in_degree[a]++;
+			}
+		} else {
+			long value = constraint.get_value();
+			switch (constraint.get_relation()) {
+				case LineConstraint::EQUAL:
+					this->lower[a] = std::max(this->lower[a], value);
+					this->upper[a] = std::min(this->upper[a], value);
+					break;
+				case LineConstraint::LESS:
+					this->upper[a] = std::min(this->upper[a], value - 1);
+					break;
+				case LineConstraint::GREATER:
+					this->lower[a] = std::max(this->lower[a], value + 1);
+					break;
+			}
+		}
+	}
+	
+	// 3. Longest path in topological order
+	std::vector<long> values(size, 0);
+	std::vector<int> queue;
+	for (int node = 0; node < size; node++) {
+		if (this->parents[node] == node) {
+			values[node] = this->lower[node];
+			if (in_degree[node] == 0) {
+				queue.push_back(node);
+			}
+		}
+	}
+	
+	for (size_t k = 0; k < queue.size(); k++) {
+		int node = queue[k];
+		if (values[node] > this->upper[node]) {
+			return false;
+		}
+		for (int next : this->successors[node]) {
+			values[next] = std::max(values[next], values[node] + 1);
+			if (--in_degree[next] == 0) {
+				queue.push_back(next);
+			}
+		}
+	}
+	
+	for (int node = 0; node < size; node++) {
+		if (this->parents[node] == node && in_degree[node] > 0) {
+			// Cycle
+			return false;
+		}
+	}
+	
+	// 4. Save solution
+	for (auto const &entry : this->variables) {
+		int type = entry.first.first;
+		int index = entry.first.second;
+		int value = (int) values[this->find(entry.second)];
+		switch (type) {
+			case LineConstraint::H_LINE:
+				solution.set_h_line(index, value);
+				break;
+			case LineConstraint::V_LINE:
+				solution.set_v_line(index, value);
+				break;
+			case LineConstraint::D_LINE:
+				solution.set_d_line(index, value);
+				break;
+			case LineConstraint::WAVE:
+				solution.set_wave(value);
+				break;
+			case LineConstraint::WAVE_COLUMN:
+				solution.set_wave_column(value);
+				break;
+		}
+	}
+	
+	return true;
+}
+
+int DifferenceSolver::get_variable(int type, int index) {
+	auto it = this->variables.find(std::make_pair(type, index));
+	if (it != this->variables.end()) {
+		return it->second;
+	}
+	
+	int node = this->parents.size();
+	this->variables[std::make_pair(type, index)] = node;
+	this->parents.push_back(node);
+	this->lower.push_back(0);
+	this->upper.push_back(this->get_max_value(type));
+	return node;
+}
+
+int DifferenceSolver::find(int node) {
+	while (this->parents[node] != node) {
+		this->parents[node] = this->parents[this->parents[node]];
+		node = this->parents[node];
+	}
+	return node;
+}
+
+/**
+ * Same domains as the CSP variables
+ */
+long DifferenceSolver::get_max_value(int type) {
+	switch (type) {
+		case LineConstraint::D_LINE:
+			return this->max_d_value;
+		case LineConstraint::SITE:
+			return 1000;
+		case LineConstraint::WAVE:
+			return INT_MAX;
+		default:
+			return 1;
+	}
+}
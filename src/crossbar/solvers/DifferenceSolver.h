@@ -0,0 +1,37 @@
+#ifndef CROSSBAR_SIMULATOR_DIFFERENCESOLVER_H
+#define CROSSBAR_SIMULATOR_DIFFERENCESOLVER_H
+
+#include <map>
+#include <vector>
+#include <utility>
+
+#include "crossbar/LineConstraint.h"
+#include "crossbar/CrossbarSolution.h"
+
+/**
+ * Solver for the constraints that only fix lines to a value or order
+ * two lines (difference constraints). The lowest solution is the longest
+ * path over the graph of strict inequalities, so no search is needed.
+ */
+class DifferenceSolver {
+public:
+	DifferenceSolver(long max_d_value);
+	
+	bool solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution);
+	
+private:
+	long max_d_value;
+	
+	// Variables of the current problem (equal variables share a node)
+	std::map<std::pair<int, int>, int> variables;
+	std::vector<int> parents;
+	std::vector<long> lower;
+	std::vector<long> upper;
+	std::vector<std::vector<int> > successors;
+	
+	int get_variable(int type, int index);
+	int find(int node);
+	long get_max_value(int type);
+};
+
+#endif /* CROSSBAR_SIMULATOR_DIFFERENCESOLVER_H */
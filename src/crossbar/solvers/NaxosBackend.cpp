@@ -0,0 +1,147 @@
+#include <climits>
+#include <stdexcept>
+
+#include "NaxosBackend.h"
+#include "crossbar/CrossbarModel.h"
+
+NaxosBackend::NaxosBackend() {
+	
+}
+
+NaxosBackend::~NaxosBackend() {
+	this->release();
+}
+
+std::string NaxosBackend::get_name() {
+	return "naxos";
+}
+
+/**
+ * Start a new problem. Naxos can not retract constraints, so the problem
+ * manager is recreated with only the variables of these constraints.
+ */
+void NaxosBackend::release() {
+	for (auto const &entry : this->variables) {
+		delete entry.second;
+	}
+	this->variables.clear();
+	
+	delete this->pm;
+	this->pm = NULL;
+}
+
+void NaxosBackend::solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution) {
+	this->release();
+	this->pm = new naxos::NsProblemManager();
+	
+	for (const LineConstraint& constraint : constraints) {
+		this->add_constraint(constraint);
+	}
+	
+	// Add objective to minimize (only the control lines)
+	naxos::NsIntVarArray vObjectiveTerms;
+	for (auto const &entry : this->variables) {
+		if (entry.first.first != LineConstraint::SITE) {
+			vObjectiveTerms.push_back(*entry.second);
+		}
+	}
+	
+	if (vObjectiveTerms.size() > 0) {
+		// Add labeling
+		this->pm->addGoal(new naxos::NsgLabeling(vObjectiveTerms));
+		
+		try {
+			this->pm->minimize(naxos::NsSum(vObjectiveTerms));
+		} catch (...) {
+			// Keep the first solution found if the objective can not be minimized
+		}
+	}
+	
+	if (!this->pm->nextSolution()) {
+		throw std::runtime_error("Conflict between parallel operations");
+	}
+	
+	// Save solution
+	for (auto const &entry : this->variables) {
+		int index = entry.first.second;
+		int value = entry.second->value();
+		switch (entry.first.first) {
+			case LineConstraint::H_LINE:
+				solution.set_h_line(index, value);
+				break;
+			case LineConstraint::V_LINE:
+				solution.set_v_line(index, value);
+				break;
+			case LineConstraint::D_LINE:
+				solution.set_d_line(index, value);
+				break;
+			case LineConstraint::WAVE:
+				solution.set_wave(value);
+				break;
+			case LineConstraint::WAVE_COLUMN:
+				solution.set_wave_column(value);
+				break;
+		}
+	}
+}
+
+/**
+ * Translate a constraint into the naxos problem
+ * @param constraint
+ */
+void NaxosBackend::add_constraint(const LineConstraint& constraint) {
+	naxos::NsIntVar* var = this->get_variable(constraint.get_type(), constraint.get_index());
+	
+	if (constraint.is_binary()) {
+		naxos::NsIntVar* other = this->get_variable(constraint.get_other_type(), constraint.get_other_index());
+		switch (constraint.get_relation()) {
+			case LineConstraint::EQUAL:
+				this->pm->add(*var == *other);
+				break;
+			case LineConstraint::LESS:
+				this->pm->add(*var < *other);
+				break;
+			case LineConstraint::GREATER:
+				this->pm->add(*var > *other);
+				break;
+		}
+	} else {
+		switch (constraint.get_relation()) {
+			case LineConstraint::EQUAL:
+				this->pm->add(*var == constraint.get_value());
+				break;
+			case LineConstraint::LESS:
+				this->pm->add(*var < constraint.get_value());
+				break;
+			case LineConstraint::GREATER:
+				this->pm->add(*var > constraint.get_value());
+				break;
+		}
+	}
+}
+
+/**
+ * Get the variable of a line, creating it on first use
+ */
+naxos::NsIntVar* NaxosBackend::get_variable(int type, int index) {
+	naxos::NsIntVar*& var = this->variables[std::make_pair(type, index)];
+	if (var == NULL) {
+		long max;
+		switch (type) {
+			case LineConstraint::D_LINE:
+				max = CrossbarModel::MAX_QL_VOLTAGE;
+				break;
+			case LineConstraint::SITE:
+				max = 1000;
+				break;
+			case LineConstraint::WAVE:
+				max = INT_MAX;
+				break;
+			default:
+				max = 1;
+				break;
+		}
+		var = new naxos::NsIntVar(*this->pm, 0, max);
+	}
+	return var;
+}
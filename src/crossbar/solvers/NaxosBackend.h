@@ -0,0 +1,32 @@
+#ifndef CROSSBAR_SIMULATOR_NAXOSBACKEND_H
+#define CROSSBAR_SIMULATOR_NAXOSBACKEND_H
+
+#include <map>
+#include <utility>
+#include <naxos.h>
+
+#include "ConstraintBackend.h"
+
+/**
+ * Backend that labels and minimizes the lines with the naxos CSP solver
+ */
+class NaxosBackend : public ConstraintBackend {
+public:
+	NaxosBackend();
+	~NaxosBackend();
+	
+	std::string get_name();
+	void solve(const std::vector<LineConstraint>& constraints, CrossbarSolution& solution);
+	
+private:
+	naxos::NsProblemManager* pm = NULL;
+	
+	// Variables of the current problem by (type, index)
+	std::map<std::pair<int, int>, naxos::NsIntVar*> variables;
+	
+	void release();
+	void add_constraint(const LineConstraint& constraint);
+	naxos::NsIntVar* get_variable(int type, int index);
+};
+
+#endif /* CROSSBAR_SIMULATOR_NAXOSBACKEND_H */
@@ -1,23 +1,23 @@
 #ifndef EXECUTOR_H
 #define EXECUTOR_H
 
+#include <memory>
 #include <iostream>
 #include <QObject>
-#include <QTimer>
-#include <QWidget>
-#include <interval-tree.h>
 
 #include "crossbar/CrossbarModel.h"
 #include "crossbar/operations/Operation.h"
 #include "crossbar/ConstraintChecker.h"
-#include "gui/crossbar-grid/CrossbarGrid.h"
-#include "gui/editor/CodeEditor.h"
+#include "FrameBuffer.h"
 
+/**
+ * Runs a program at full speed on its own crossbar and pushes the state
+ * after every cycle into a frame buffer (a Player shows them)
+ */
 class Executor : public QObject {
 	Q_OBJECT
 public:
-	Executor(CrossbarModel* model, bool active_animations,
-		int speed, CodeEditor* editor, CrossbarGrid* grid,
+	Executor(CrossbarModel* model, std::shared_ptr<FrameBuffer> frames,
 		std::vector<std::vector<Operation*> > operations);
 	~Executor();
 	
@@ -25,20 +25,14 @@ signals:
 	void finished();
 	void finished_ok();
 	void finished_err(const char* message);
-	void cycle_done(int cycle);
 
 public slots:
 	void doWork();
 	
 private:
 	CrossbarModel* model;
-	bool active_animations;
-	int speed;
-	CodeEditor* editor;
-	CrossbarGrid* grid;
+	std::shared_ptr<FrameBuffer> frames;
 	std::vector<std::vector<Operation*> > operations;
-	
-	double get_waiting_seconds(int speed);
 };
 
 #endif /* EXECUTOR_H */
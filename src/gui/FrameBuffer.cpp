@@ -0,0 +1,97 @@
+#include "FrameBuffer.h"
+
+FrameBuffer::FrameBuffer() {
+	this->first_cycle = 0;
+	this->finished = false;
+	this->cancelled = false;
+}
+
+FrameBuffer::~FrameBuffer() {
+	for (CrossbarModel* frame : this->frames) {
+		delete frame;
+	}
+}
+
+/**
+ * Add the state after the next cycle (the buffer owns it), waiting while
+ * the buffer is full
+ * @param frame
+ * @return false if the buffer was cancelled (the frame is deleted)
+ */
+bool FrameBuffer::push(CrossbarModel* frame) {
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->released.wait(lock, [this]() {
+		return this->cancelled || (int) this->frames.size() < FrameBuffer::MAX_FRAMES;
+	});
+	
+	if (this->cancelled) {
+		delete frame;
+		return false;
+	}
+	this->frames.push_back(frame);
+	return true;
+}
+
+/**
+ * No more frames will be pushed
+ */
+void FrameBuffer::finish() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->finished = true;
+}
+
+/**
+ * Nobody reads the frames anymore: the executor stops at the next push
+ */
+void FrameBuffer::cancel() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->cancelled = true;
+	}
+	this->released.notify_all();
+}
+
+/**
+ * Delete the frames before a cycle (already shown)
+ * @param cycle
+ */
+void FrameBuffer::release(int cycle) {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		while (this->first_cycle < cycle && !this->frames.empty()) {
+			delete this->frames.front();
+			this->frames.pop_front();
+			this->first_cycle++;
+		}
+	}
+	this->released.notify_all();
+}
+
+/**
+ * @return state after a cycle (NULL if not computed yet or released)
+ */
+CrossbarModel* FrameBuffer::get(int cycle) {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	if (cycle < this->first_cycle || cycle >= this->first_cycle + (int) this->frames.size()) {
+		return NULL;
+	}
+	return this->frames[cycle - this->first_cycle];
+}
+
+/**
+ * @return number of frames pushed so far (released or not)
+ */
+int FrameBuffer::get_size() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->first_cycle + this->frames.size();
+}
+
+bool FrameBuffer::is_finished() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->finished;
+}
+
+bool FrameBuffer::is_cancelled() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->cancelled;
+}
@@ -0,0 +1,47 @@
+#ifndef CROSSBAR_SIMULATOR_FRAMEBUFFER_H
+#define CROSSBAR_SIMULATOR_FRAMEBUFFER_H
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <condition_variable>
+
+#include "crossbar/CrossbarModel.h"
+
+/**
+ * Snapshot of the crossbar after every cycle, written by the executor
+ * thread and read by the player. The snapshots are never modified once
+ * pushed (they share the site table and register copy on write). Only the
+ * frames not shown yet are kept, and at most MAX_FRAMES of them: the
+ * executor waits for the player when it is that far ahead.
+ */
+class FrameBuffer {
+public:
+	FrameBuffer();
+	~FrameBuffer();
+	
+	bool push(CrossbarModel* frame);
+	void finish();
+	void cancel();
+	void release(int cycle);
+	
+	CrossbarModel* get(int cycle);
+	int get_size();
+	bool is_finished();
+	bool is_cancelled();
+	
+private:
+	static const int MAX_FRAMES = 256;
+	
+	std::mutex mutex;
+	std::condition_variable released;
+	
+	// Frames from first_cycle on
+	std::deque<CrossbarModel*> frames;
+	int first_cycle;
+	
+	bool finished;
+	bool cancelled;
+};
+
+#endif /* CROSSBAR_SIMULATOR_FRAMEBUFFER_H */
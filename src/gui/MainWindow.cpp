@@ -4,7 +4,6 @@ MainWindow::MainWindow(QWidget* parent, int size, int data_qubits, int ancilla_q
 	this->parent = parent;
 	this->ui = new Ui::MainWindow();
 	this->ui->setupUi(this);
-	this->executorThread = new QThread();
 	
 	// Params for crossbar model
 	this->model = new CrossbarModel(size, data_qubits, ancilla_qubits);
@@ -27,26 +26,8 @@ MainWindow::MainWindow(QWidget* parent, nlohmann::json topology) {
 	this->parent = parent;
 	this->ui = new Ui::MainWindow();
 	this->ui->setupUi(this);
-	this->executorThread = new QThread();
 	
-	int y_size = (int) topology["y_size"];
-	int x_size = (int) topology["x_size"];
-	this->model = new CrossbarModel(y_size, x_size,  0, 0);
-	
-	for (nlohmann::json::const_iterator it = topology["init_configuration"].begin();
-			it != topology["init_configuration"].end(); ++it)
-	{
-		int q_id = std::stoi(it.key());
-		std::string type = it.value()["type"];
-		std::vector<int> value = it.value()["position"];
-		int i = value[0];
-		int j = value[1];
-		model->add_qubit(q_id, new Qubit(
-			(j % 2 == 0) ? new QubitState(0, 1) : new QubitState(1, 0),
-			new QubitPosition(i, j),
-			(type.compare("ancilla") == 0)
-		));
-	}
+	this->model = TopologyLoader::load(topology);
 	
     // Center window
     QDesktopWidget* desktop = QApplication::desktop();
@@ -63,6 +44,7 @@ MainWindow::MainWindow(QWidget* parent, nlohmann::json topology) {
 }
 
 MainWindow::~MainWindow() {
+	this->stop_player();
 	delete ui;
 }
 
@@ -94,9 +76,6 @@ void MainWindow::draw_window() {
 	delete ui->crossbarGrid;
 	this->grid = new CrossbarGrid(ui->centralWidget, this->model);	
 	this->ui->horizontalLayout_2->insertWidget(1, this->grid);
-	this->connect(this->grid, SIGNAL(notified_signal()), this->grid, SLOT(notified_slot()));
-	this->connect(this->grid, SIGNAL(notified_resize_signal()), this->grid, SLOT(notified_resize_slot()));
-	this->grid->notified_resize();
 	
 	// Save model
 	this->originalModel = this->model->clone();
@@ -160,6 +139,7 @@ void MainWindow::safe_evolve() {
 }
 
 void MainWindow::safe_reset() {
+	this->stop_player();
 	delete this->model;
 	this->model = this->originalModel;
 	this->grid->setModel(this->model);
@@ -228,12 +208,7 @@ std::vector<std::vector<Operation*> > MainWindow::safe_parse_code(std::string te
 			num_qubits = std::max(element.first + 1, num_qubits);
 		}
 		
-		std::regex exp("qubits(\\s|\\t|\\n|\\r)*[0-9]+");
-		text = std::regex_replace(
-			text,
-			exp,
-			"qubits " + std::to_string(num_qubits)
-		);
+		text = CQASMParser::set_num_qubits(text, num_qubits);
 		
 		std::vector<std::vector<Operation*> > operations = CQASMParser::parse(text);
 		
@@ -280,19 +255,30 @@ void MainWindow::safe_execute_code(std::vector<std::vector<Operation*> > operati
 	try {
 		std::cout << "Operations: " << operations.size() << std::endl << std::flush;
 		
-		Executor* executor = new Executor(
-			this->model, Settings::active_animation, Settings::speed,
-			this->editor, this->grid, operations
-		);
+		// Stop the animation of a previous run
+		this->stop_player();
+		this->editor->setReadOnly(true);
+		
+		// The executor computes every cycle on a copy of the crossbar, in a
+		// thread of its own for this run...
+		this->frames = std::make_shared<FrameBuffer>();
+		this->executorThread = new QThread();
+		Executor* executor = new Executor(this->model->clone(), this->frames, operations);
 		executor->moveToThread(this->executorThread);
 		this->connect(this->executorThread, SIGNAL(started()), executor, SLOT(doWork()));
 		this->connect(executor, SIGNAL(finished()), executor, SLOT(deleteLater()));
 		this->connect(executor, SIGNAL(finished()), this->executorThread, SLOT(quit()));
-		this->connect(executor, SIGNAL(cycle_done(int)), this, SLOT(cycle_done(int)));
 		this->connect(executor, SIGNAL(finished_ok()), this, SLOT(finished_executing_code_ok()));
 		this->connect(executor, SIGNAL(finished_err(const char*)),
 				this, SLOT(finished_executing_code_err(const char*)));
-		executorThread->start();
+		
+		// ...and the player shows them on the crossbar of the grid
+		this->player = new Player(this->model, this->frames, Settings::active_animation, Settings::speed);
+		this->connect(this->player, SIGNAL(frame_shown(int)), this, SLOT(cycle_done(int)));
+		this->connect(this->player, SIGNAL(finished()), this, SLOT(finished_playing()));
+		
+		this->executorThread->start();
+		this->player->start();
 	} catch (const std::exception ex) {
 		this->set_status("Executor", ex.what());
 	}
@@ -313,6 +299,37 @@ void MainWindow::cycle_done(int cycle) {
 	this->set_status("Executor", (std::string("Cycle ") + std::to_string(cycle) + " done").c_str());
 }
 
+/**
+ * Slot called when the player has shown the last frame
+ */
+void MainWindow::finished_playing() {
+	this->stop_player();
+}
+
+/**
+ * Stop showing the frames of an execution and stop the executor if it is
+ * still computing them
+ */
+void MainWindow::stop_player() {
+	if (this->player != NULL) {
+		this->player->stop();
+		this->player->deleteLater();
+		this->player = NULL;
+	}
+	
+	if (this->executorThread != NULL) {
+		// The executor leaves its cycle loop at the next frame and the thread
+		// ends without waiting for the queued quit
+		this->frames->cancel();
+		this->executorThread->quit();
+		this->executorThread->wait();
+		delete this->executorThread;
+		this->executorThread = NULL;
+		this->frames.reset();
+	}
+	this->editor->setReadOnly(false);
+}
+
 /**
  * Show a status message
  */
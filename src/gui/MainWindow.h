@@ -19,6 +19,7 @@
 #include <QByteArray>
 
 #include "parser/CQASMParser.h"
+#include "parser/TopologyLoader.h"
 #include "crossbar/operations/Operation.h"
 #include "crossbar/CrossbarModel.h"
 #include "crossbar/ConstraintChecker.h"
@@ -28,6 +29,7 @@
 #include "editor/CodeEditor.h"
 #include "crossbar-grid/CrossbarGrid.h"
 #include "Executor.h"
+#include "Player.h"
 
 namespace Ui {
 	class MainWindow;
@@ -58,6 +60,7 @@ private slots:
 	void finished_executing_code_ok();
 	void finished_executing_code_err(const char* message);
 	void cycle_done(int cycle);
+	void finished_playing();
 	
 private:
 	// GUI elements
@@ -66,6 +69,8 @@ private:
 	CrossbarGrid* grid;
 	CodeEditor* editor;
 	QThread* executorThread = NULL;
+	std::shared_ptr<FrameBuffer> frames;
+	Player* player = NULL;
 	
 	// Crossbar
 	CrossbarModel* model = NULL;
@@ -76,6 +81,7 @@ private:
 	bool safe_check_code(std::vector<std::vector<Operation*> > operations);
 	std::vector<std::vector<Operation*> > safe_parse_code(std::string text);
 	void safe_execute_code(std::vector<std::vector<Operation*> > operations);
+	void stop_player();
 	
 	// Utils
 	std::string get_editor_text();
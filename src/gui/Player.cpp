@@ -0,0 +1,51 @@
+#include <algorithm>
+
+#include "Player.h"
+
+Player::Player(CrossbarModel* model, std::shared_ptr<FrameBuffer> frames, bool active_animations, int speed) {
+	this->model = model;
+	this->frames = frames;
+	this->active_animations = active_animations;
+	this->speed = speed;
+	this->next_frame = 0;
+	
+	this->connect(&this->timer, SIGNAL(timeout()), this, SLOT(tick()));
+}
+
+Player::~Player() {
+	
+}
+
+void Player::start() {
+	this->timer.start(this->active_animations ? 1000 / std::max(1, this->speed) : Player::POLL_INTERVAL);
+}
+
+void Player::stop() {
+	this->timer.stop();
+}
+
+/**
+ * Show the next frame (or the last one without animations); stop once
+ * the executor has finished and every frame has been shown
+ */
+void Player::tick() {
+	// Read in this order: once finished, the size is final
+	bool done = this->frames->is_finished();
+	int size = this->frames->get_size();
+	
+	if (this->next_frame < size) {
+		this->show(this->active_animations ? this->next_frame : size - 1);
+	}
+	
+	if (done && this->next_frame >= size) {
+		this->timer.stop();
+		emit finished();
+	}
+}
+
+void Player::show(int cycle) {
+	this->model->restore(this->frames->get(cycle));
+	this->frames->release(cycle);
+	this->next_frame = cycle + 1;
+	emit frame_shown(cycle);
+}
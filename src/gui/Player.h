@@ -0,0 +1,48 @@
+#ifndef CROSSBAR_SIMULATOR_PLAYER_H
+#define CROSSBAR_SIMULATOR_PLAYER_H
+
+#include <memory>
+#include <QObject>
+#include <QTimer>
+
+#include "crossbar/CrossbarModel.h"
+#include "FrameBuffer.h"
+
+/**
+ * Replays the frames of an execution on the crossbar shown by the GUI,
+ * one per tick of a timer of the GUI thread, while the executor may
+ * still be computing the next ones. Without animations it shows the last
+ * computed frame.
+ */
+class Player : public QObject {
+	Q_OBJECT
+public:
+	Player(CrossbarModel* model, std::shared_ptr<FrameBuffer> frames, bool active_animations, int speed);
+	~Player();
+	
+	void start();
+	void stop();
+	
+signals:
+	void frame_shown(int cycle);
+	void finished();
+	
+private slots:
+	void tick();
+	
+private:
+	// Polling interval while waiting for frames without animations (ms)
+	static const int POLL_INTERVAL = 50;
+	
+	CrossbarModel* model;
+	std::shared_ptr<FrameBuffer> frames;
+	bool active_animations;
+	int speed;
+	
+	QTimer timer;
+	int next_frame;
+	
+	void show(int cycle);
+};
+
+#endif /* CROSSBAR_SIMULATOR_PLAYER_H */
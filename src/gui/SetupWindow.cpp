@@ -33,8 +33,8 @@ void SetupWindow::draw_window() {
 }
 
 void SetupWindow::open_main_window(int size, int data_qubits, int ancilla_qubits) {
-	if (size < 2 || size > 10) {
-		throw std::runtime_error("Size must be between 2 and 10");
+	if (size < 2 || size > 256) {
+		throw std::runtime_error("Size must be between 2 and 256");
 	}
 
 	if (data_qubits + ancilla_qubits > size * size) {
@@ -103,18 +103,10 @@ void SetupWindow::load_json_clicked() {
 		nlohmann::json config;
 		i >> config;
 		
-		if (config.count("topology") <= 0) {
-			this->show_alert("Invalid file", "File does not have the topology field");
-			return;
-		}
-		
-		if (config["topology"].count("init_configuration") <= 0) {
-			this->show_alert("Invalid file", "File does not have the init_configuration");
-			return;
-		}
-		
-		if (config["topology"].count("x_size") <= 0 || config["topology"].count("y_size") <= 0) {
-			this->show_alert("Invalid file", "File does not have the size fields");
+		try {
+			TopologyLoader::validate(config);
+		} catch (std::runtime_error e) {
+			this->show_alert("Invalid file", e.what());
 			return;
 		}
 		
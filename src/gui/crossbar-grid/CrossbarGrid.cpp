@@ -1,5 +1,8 @@
+#include <cmath>
 #include <iostream>
+#include <algorithm>
 #include <QString>
+#include <QPainterPath>
 #include <QCoreApplication>
 #include "CrossbarGrid.h"
 #include "crossbar/CrossbarModel.h"
@@ -17,6 +20,16 @@ QPen CrossbarGrid::BLUE_PEN_DASHED = QPen(QBrush(QColor(100, 100, 200)), Crossba
 CrossbarGrid::CrossbarGrid(QWidget* parent, CrossbarModel* model) : QGraphicsView(parent) {
 	this->scene = new QGraphicsScene(this);
 	this->setScene(scene);
+	this->setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+	this->setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+	this->setDragMode(QGraphicsView::ScrollHandDrag);
+	this->detail_layer = NULL;
+	this->overview_item = NULL;
+	this->overview = false;
+	
+	// Connected before subscribing: the model notifies the grid right away
+	this->connect(this, SIGNAL(notified_signal()), this, SLOT(notified_slot()));
+	this->connect(this, SIGNAL(notified_resize_signal()), this, SLOT(notified_resize_slot()));
 	this->setModel(model);
 }
 
@@ -49,7 +62,7 @@ std::map<int, QGraphicsRectItem*> CrossbarGrid::draw_wave_items(int active_wave,
 			brush = QBrush(Qt::white);
 		}
 		rect->setBrush(brush);
-		this->scene->addItem(rect);
+		rect->setParentItem(this->detail_layer);
 		wave_items[j] = rect;
 	}
 	
@@ -75,14 +88,15 @@ std::map<int, QGraphicsLineItem*> CrossbarGrid::draw_h_lines(int count) {
 		QGraphicsLineItem* line = new QGraphicsLineItem(x1, y1, x2, y2);
 		QPen pen = (this->model->is_h_barrier_down(key)) ? CrossbarGrid::BLUE_PEN_DASHED : CrossbarGrid::BLUE_PEN;
 		line->setPen(pen);
-		this->scene->addItem(line);
+		line->setParentItem(this->detail_layer);
 
 		// Add button only for the real control lines
 		if (key != -1 && key != count) {
 			line_items.insert(std::pair<int, QGraphicsLineItem*>(key, line));
 			LineTogglerCircle* circle = new LineTogglerCircle(x1, y1);
+			circle->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 			circle->set_callback(key, this->model, &CrossbarModel::toggle_h_line);
-			this->scene->addItem(circle);
+			circle->setParentItem(this->detail_layer);
 		}
 		i++;
 	}
@@ -109,14 +123,15 @@ std::map<int, QGraphicsLineItem*> CrossbarGrid::draw_v_lines(int count) {
 		QGraphicsLineItem* line = new QGraphicsLineItem(x1, y1, x2, y2);
 		QPen pen = (this->model->is_v_barrier_down(key)) ? CrossbarGrid::RED_PEN_DASHED : CrossbarGrid::RED_PEN;
 		line->setPen(pen);
-		this->scene->addItem(line);
+		line->setParentItem(this->detail_layer);
 
 		// Add button only for the real control lines
 		if (key != -1 && key != count) {
 			line_items[key] = line;
 			LineTogglerCircle* circle = new LineTogglerCircle(x2, y2);
+			circle->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 			circle->set_callback(key, this->model, &CrossbarModel::toggle_v_line);
-			this->scene->addItem(circle);
+			circle->setParentItem(this->detail_layer);
 		}
 		i++;
 	}
@@ -131,6 +146,14 @@ std::map<int, QGraphicsLineItem*> CrossbarGrid::draw_v_lines(int count) {
  */
 std::map<int, TextValueChanger*> CrossbarGrid::draw_d_lines(int count) {
 	std::map<int, TextValueChanger*> value_items;
+	
+	// The lines never change: one cached item for all of them
+	QGraphicsPathItem* lines_item = new QGraphicsPathItem();
+	lines_item->setPen(CrossbarGrid::GRAY_PEN);
+	lines_item->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+	lines_item->setParentItem(this->detail_layer);
+	QPainterPath lines_path;
+	
 	int side = int((count - 1) / 2);
 	int i = 0;
 	for (int key = -1 * side; key < side + 1; key++) {
@@ -151,17 +174,18 @@ std::map<int, TextValueChanger*> CrossbarGrid::draw_d_lines(int count) {
 		}
 
 		// Draw line
-		QGraphicsLineItem* line = new QGraphicsLineItem(x1, y1, x2, y2);
-		line->setPen(CrossbarGrid::GRAY_PEN);
-		this->scene->addItem(line);
+		lines_path.moveTo(x1, y1);
+		lines_path.lineTo(x2, y2);
 
 		// Draw text value
 		value_items[key] = value_changer;
+		value_changer->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 		value_changer->setPlainText(QString::number(this->model->get_d_line(key), 'd', 1));
 		value_changer->set_callback(key, this->model, &CrossbarModel::change_d_line);
-		this->scene->addItem(value_changer);
+		value_changer->setParentItem(this->detail_layer);
 		i++;
 	}
+	lines_item->setPath(lines_path);
 	
 	return value_items;
 }
@@ -176,9 +200,10 @@ std::map<int, QubitCircle*> CrossbarGrid::draw_qubits() {
 		int y = CrossbarGrid::OUTER_MARGIN + (this->m - pos->get_i()) * CrossbarGrid::SQUARE_WIDTH;
 		int x = CrossbarGrid::OUTER_MARGIN + (pos->get_j() + 1) * CrossbarGrid::SQUARE_WIDTH;
 		qubit_items[q_id] = new QubitCircle(q_id, qubit->get_is_ancillary());
+		qubit_items[q_id]->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 		qubit_items[q_id]->setPos(x, y);
 		
-		this->scene->addItem(qubit_items[q_id]);
+		qubit_items[q_id]->setParentItem(this->detail_layer);
 	}
 	
 	return qubit_items;
@@ -196,55 +221,138 @@ void CrossbarGrid::setModel(CrossbarModel* model) {
 }
 
 void CrossbarGrid::notified() {
-	emit notified_signal();
+	ChangeSet changes;
+	changes.set_all_changed();
+	this->notified_changes(changes);
+}
+
+/**
+ * Keep the changes until the slot repaints them; one signal is pending
+ * at most, so the changes of several cycles are repainted together
+ */
+void CrossbarGrid::notified_changes(const ChangeSet& changes) {
+	bool was_empty;
+	{
+		std::lock_guard<std::mutex> lock(this->changes_mutex);
+		was_empty = this->pending_changes.empty();
+		this->pending_changes.merge(changes);
+	}
+	
+	if (was_empty) {
+		emit notified_signal();
+	}
 }
 
 /**
- * Handle the changes of the model
+ * Handle the changes of the model: only the items that changed are repainted
  */
 void CrossbarGrid::notified_slot() {
-	// Repaint active wave
-	std::map<int, QGraphicsRectItem*>::iterator it_wave;
-	for (it_wave = this->wave_items.begin(); it_wave != this->wave_items.end(); it_wave++) {
-		QBrush brush;
-		if (this->model->get_active_wave() == 2 && it_wave->first % 2 == 0) {
-			brush = QBrush(Qt::red);
-		} else if (this->model->get_active_wave() == 1 && it_wave->first % 2 == 1) {
-			brush = QBrush(Qt::blue);
+	ChangeSet changes;
+	{
+		std::lock_guard<std::mutex> lock(this->changes_mutex);
+		std::swap(changes, this->pending_changes);
+	}
+	
+	// Zoomed out, the items are hidden and repainted when zooming in
+	if (!this->overview) {
+		if (changes.is_all_changed()) {
+			this->repaint_detail_items();
 		} else {
-			brush = QBrush(Qt::white);
+			if (changes.is_wave_changed()) {
+				this->repaint_wave();
+			}
+			for (int k : changes.get_h_lines()) {
+				this->repaint_h_line(k);
+			}
+			for (int k : changes.get_v_lines()) {
+				this->repaint_v_line(k);
+			}
+			for (int k : changes.get_d_lines()) {
+				this->repaint_d_line(k);
+			}
+			for (int q_id : changes.get_qubits()) {
+				this->repaint_qubit(q_id);
+			}
 		}
-		this->wave_items[it_wave->first]->setBrush(brush);
 	}
-	// Repaint horizontal lines
-	std::map<int, QGraphicsLineItem*>::iterator it_line;
-	for (it_line = this->h_line_items.begin(); it_line != this->h_line_items.end(); it_line++) {
-		QPen pen = (this->model->is_h_barrier_down(it_line->first)) ? CrossbarGrid::BLUE_PEN_DASHED : CrossbarGrid::BLUE_PEN;
-		this->h_line_items[it_line->first]->setPen(pen);
+	
+	// Zoomed out, only the sites touched by the changes are rasterized again
+	if (this->overview) {
+		DirtyRegion region;
+		if (changes.is_all_changed()) {
+			region.add(0, 0, this->m - 1, this->n - 1);
+		} else {
+			region = this->model->get_dirty_region(changes);
+		}
+		this->render_overview(region);
 	}
-	// Repaint vertical lines
-	for (it_line = this->v_line_items.begin(); it_line != this->v_line_items.end(); it_line++) {
-		QPen pen = (this->model->is_v_barrier_down(it_line->first)) ? CrossbarGrid::RED_PEN_DASHED : CrossbarGrid::RED_PEN;
-		this->v_line_items[it_line->first]->setPen(pen);
+	
+	// The scene schedules the repaint of the changed items
+	QCoreApplication::processEvents();
+}
+
+/**
+ * Repaint all the items drawn when zoomed in
+ */
+void CrossbarGrid::repaint_detail_items() {
+	this->repaint_wave();
+	for (auto const &entry : this->h_line_items) {
+		this->repaint_h_line(entry.first);
 	}
-	// Repaint diagonal lines
-	std::map<int, TextValueChanger*>::iterator it_text;
-	for (it_text = this->d_text_items.begin(); it_text != this->d_text_items.end(); it_text++) {
-		this->d_text_items[it_text->first]->setPlainText(QString::number(this->model->get_d_line(it_text->first), 'd', 1));
+	for (auto const &entry : this->v_line_items) {
+		this->repaint_v_line(entry.first);
 	}
-	// Repaint the qubits
-	for (auto const &entry : this->model->iter_qubits_positions()) {
-		int q_id = entry.first;
-		QubitPosition* pos = entry.second->get_position();
-		
-		int y = CrossbarGrid::OUTER_MARGIN + (this->m - pos->get_i()) * CrossbarGrid::SQUARE_WIDTH;
-		int x = CrossbarGrid::OUTER_MARGIN + (pos->get_j() + 1) * CrossbarGrid::SQUARE_WIDTH;
-		this->qubit_items[q_id]->setPos(x, y);
+	for (auto const &entry : this->d_text_items) {
+		this->repaint_d_line(entry.first);
+	}
+	for (auto const &entry : this->qubit_items) {
+		this->repaint_qubit(entry.first);
+	}
+}
+
+void CrossbarGrid::repaint_wave() {
+	for (auto const &entry : this->wave_items) {
+		QBrush brush;
+		if (this->model->get_active_wave() == 2 && entry.first % 2 == 0) {
+			brush = QBrush(Qt::red);
+		} else if (this->model->get_active_wave() == 1 && entry.first % 2 == 1) {
+			brush = QBrush(Qt::blue);
+		} else {
+			brush = QBrush(Qt::white);
+		}
+		entry.second->setBrush(brush);
 	}
+}
+
+void CrossbarGrid::repaint_h_line(int k) {
+	auto it = this->h_line_items.find(k);
+	if (it == this->h_line_items.end()) return;
 	
-	// Update view
-	this->update();
-	QCoreApplication::processEvents();
+	it->second->setPen((this->model->is_h_barrier_down(k)) ? CrossbarGrid::BLUE_PEN_DASHED : CrossbarGrid::BLUE_PEN);
+}
+
+void CrossbarGrid::repaint_v_line(int k) {
+	auto it = this->v_line_items.find(k);
+	if (it == this->v_line_items.end()) return;
+	
+	it->second->setPen((this->model->is_v_barrier_down(k)) ? CrossbarGrid::RED_PEN_DASHED : CrossbarGrid::RED_PEN);
+}
+
+void CrossbarGrid::repaint_d_line(int k) {
+	auto it = this->d_text_items.find(k);
+	if (it == this->d_text_items.end()) return;
+	
+	it->second->setPlainText(QString::number(this->model->get_d_line(k), 'd', 1));
+}
+
+void CrossbarGrid::repaint_qubit(int q_id) {
+	auto it = this->qubit_items.find(q_id);
+	QubitPosition* pos = this->model->get_position(q_id);
+	if (it == this->qubit_items.end() || pos == NULL) return;
+	
+	int y = CrossbarGrid::OUTER_MARGIN + (this->m - pos->get_i()) * CrossbarGrid::SQUARE_WIDTH;
+	int x = CrossbarGrid::OUTER_MARGIN + (pos->get_j() + 1) * CrossbarGrid::SQUARE_WIDTH;
+	it->second->setPos(x, y);
 }
 
 void CrossbarGrid::notified_resize() {
@@ -256,35 +364,178 @@ void CrossbarGrid::notified_resize() {
  */
 void CrossbarGrid::notified_resize_slot() {
 	// Set size of view
-	int h_count, v_count, d_count;
 	std::tie(this->m, this->n) = this->model->get_dimensions();
-	std::tie(h_count, v_count, d_count) = this->model->get_control_line_dimensions();
 	this->height = 2 * CrossbarGrid::OUTER_MARGIN + (this->m + 1) * CrossbarGrid::SQUARE_WIDTH;
 	this->width = 2 * CrossbarGrid::OUTER_MARGIN + (this->n + 1) * CrossbarGrid::SQUARE_WIDTH;
-	this->setFixedSize(this->width, this->height);
 	
-	// Clear scene
+	// Big crossbars start zoomed out to fit the view
+	double zoom = std::min(1.0, CrossbarGrid::MAX_VIEW_SIZE / (double) std::max(this->width, this->height));
+	this->setFixedSize((int) std::ceil(this->width * zoom) + 2 * this->frameWidth(),
+		(int) std::ceil(this->height * zoom) + 2 * this->frameWidth());
+	this->resetTransform();
+	this->scale(zoom, zoom);
+	
+	// The whole crossbar is drawn again: the changes not repainted yet are
+	// dropped (a signal still pending repaints nothing)
+	{
+		std::lock_guard<std::mutex> lock(this->changes_mutex);
+		this->pending_changes = ChangeSet();
+	}
+	
+	// Clear scene (the items drawn when zoomed in are created on demand)
 	this->scene->clear();
+	this->scene->setSceneRect(0, 0, this->width, this->height);
+	this->detail_layer = NULL;
+	this->wave_items.clear();
+	this->h_line_items.clear();
+	this->v_line_items.clear();
+	this->d_text_items.clear();
+	this->qubit_items.clear();
+	
+	// Overview: one pixel block per site, centered on the sites of the items
+	this->overview_item = new OverviewItem(this->n * CrossbarGrid::OVERVIEW_CELL, this->m * CrossbarGrid::OVERVIEW_CELL);
+	this->overview_item->setScale(CrossbarGrid::SQUARE_WIDTH / (double) CrossbarGrid::OVERVIEW_CELL);
+	this->overview_item->setPos(CrossbarGrid::OUTER_MARGIN + CrossbarGrid::SQUARE_WIDTH / 2,
+		CrossbarGrid::OUTER_MARGIN + CrossbarGrid::SQUARE_WIDTH / 2);
+	this->overview_item->setZValue(1);
+	this->overview_item->setVisible(false);
+	this->scene->addItem(this->overview_item);
+	this->overview = false;
+	this->update_level_of_detail();
+	
+	// Update
+	this->update();
+	QCoreApplication::processEvents();
+}
+
+/**
+ * Create the items drawn when zoomed in
+ */
+void CrossbarGrid::draw_detail_items() {
+	int h_count, v_count, d_count;
+	std::tie(h_count, v_count, d_count) = this->model->get_control_line_dimensions();
+	
+	this->detail_layer = new QGraphicsRectItem();
+	this->detail_layer->setFlag(QGraphicsItem::ItemHasNoContents);
+	this->scene->addItem(this->detail_layer);
 	
 	// Wave
-	this->wave_items.clear();
 	this->wave_items = this->draw_wave_items(this->model->get_active_wave(), this->n);
 	
 	// Control lines
-	this->h_line_items.clear();
 	this->h_line_items = this->draw_h_lines(h_count);
-	
-	this->v_line_items.clear();
 	this->v_line_items = this->draw_v_lines(v_count);
-	
-	this->d_text_items.clear();
 	this->d_text_items = this->draw_d_lines(d_count);
-
+	
 	// Qubit positions
-	this->qubit_items.clear();
 	this->qubit_items = this->draw_qubits();
+}
+
+/**
+ * Zoom in and out with the wheel
+ */
+void CrossbarGrid::wheelEvent(QWheelEvent* event) {
+	double factor = (event->angleDelta().y() > 0) ? 1.25 : 0.8;
+	this->scale(factor, factor);
+	this->update_level_of_detail();
+	event->accept();
+}
+
+/**
+ * Show the items when zoomed in or the image of the crossbar when zoomed
+ * out, where the QL values, togglers and qubit labels would not be readable
+ */
+void CrossbarGrid::update_level_of_detail() {
+	if (this->overview_item == NULL) return;
 	
-	// Update
-	this->update();
-	QCoreApplication::processEvents();
+	bool overview = this->transform().m11() * CrossbarGrid::SQUARE_WIDTH < CrossbarGrid::DETAIL_MIN_PIXELS;
+	if (overview == this->overview && (overview || this->detail_layer != NULL)) return;
+	
+	this->overview = overview;
+	this->overview_item->setVisible(overview);
+	if (!overview) {
+		// The items are not kept up to date while zoomed out
+		if (this->detail_layer == NULL) {
+			this->draw_detail_items();
+		} else {
+			this->repaint_detail_items();
+		}
+	}
+	if (this->detail_layer != NULL) {
+		this->detail_layer->setVisible(!overview);
+	}
+	
+	// The image is not kept up to date while zoomed in
+	if (overview) {
+		DirtyRegion region;
+		region.add(0, 0, this->m - 1, this->n - 1);
+		this->render_overview(region);
+	}
+}
+
+/**
+ * Rasterize the sites of a region into the overview in one pass: the
+ * wave as the background of the columns, the qubits as filled blocks and
+ * each raised barrier as the first row or column of the sites above or
+ * to the right of it (lowered ones are drawn faded)
+ */
+void CrossbarGrid::render_overview(const DirtyRegion& region) {
+	const int cell = CrossbarGrid::OVERVIEW_CELL;
+	const QRgb white = qRgb(255, 255, 255);
+	const QRgb red_wave = qRgb(255, 200, 200);
+	const QRgb blue_wave = qRgb(200, 200, 255);
+	const QRgb data = qRgb(100, 200, 100);
+	const QRgb ancilla = qRgb(100, 100, 200);
+	const QRgb h_raised = qRgb(100, 100, 200);
+	const QRgb h_lowered = qRgb(215, 215, 240);
+	const QRgb v_raised = qRgb(200, 100, 100);
+	const QRgb v_lowered = qRgb(240, 215, 215);
+	int active_wave = this->model->get_active_wave();
+	QImage& image = this->overview_item->get_image();
+	
+	for (const DirtyRegion::Rect& rect : region.get_rects()) {
+		int i0 = std::max(0, rect.i0), i1 = std::min(this->m - 1, rect.i1);
+		int j0 = std::max(0, rect.j0), j1 = std::min(this->n - 1, rect.j1);
+		for (int i = i0; i <= i1; i++) {
+			// Row 0 of the crossbar is the bottom of the image
+			int y0 = (this->m - 1 - i) * cell;
+			bool h_barrier = i > 0;
+			bool h_down = h_barrier && this->model->is_h_barrier_down(i - 1);
+			for (int j = j0; j <= j1; j++) {
+				QRgb background = white;
+				if (active_wave == 2 && j % 2 == 0) {
+					background = red_wave;
+				} else if (active_wave == 1 && j % 2 == 1) {
+					background = blue_wave;
+				}
+				
+				QRgb fill = background;
+				const std::set<int>& qubits = this->model->get_qubits(i, j);
+				if (!qubits.empty()) {
+					fill = this->model->get_qubit(*qubits.begin())->get_is_ancillary() ? ancilla : data;
+				}
+				
+				bool v_barrier = j > 0;
+				bool v_down = v_barrier && this->model->is_v_barrier_down(j - 1);
+				for (int cy = 0; cy < cell; cy++) {
+					QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y0 + cy)) + j * cell;
+					for (int cx = 0; cx < cell; cx++) {
+						if (cy == cell - 1 && h_barrier) {
+							line[cx] = h_down ? h_lowered : h_raised;
+						} else if (cx == 0 && v_barrier) {
+							line[cx] = v_down ? v_lowered : v_raised;
+						} else {
+							line[cx] = fill;
+						}
+					}
+				}
+			}
+		}
+		
+		// Only the blocks of the region are painted again
+		if (i0 <= i1 && j0 <= j1) {
+			this->overview_item->update_pixels(j0 * cell, (this->m - 1 - i1) * cell,
+				(j1 - j0 + 1) * cell, (i1 - i0 + 1) * cell);
+		}
+	}
 }
@@ -2,6 +2,7 @@
 #define CROSSBAR_SIMULATOR_CROSSBARGRID_H
 
 #include <map>
+#include <mutex>
 #include <QPen>
 #include <QBrush>
 #include <QColor>
@@ -9,10 +10,15 @@
 #include <QGraphicsScene>
 #include <QGraphicsLineItem>
 #include <QGraphicsRectItem>
+#include <QGraphicsPathItem>
+#include <QWheelEvent>
 #include "LineTogglerCircle.h"
+#include "OverviewItem.h"
 #include "QubitCircle.h"
 #include "TextValueChanger.h"
 #include "crossbar/CrossbarModel.h"
+#include "crossbar/ChangeSet.h"
+#include "crossbar/DirtyRegion.h"
 #include "crossbar/Subscriber.h"
 
 class CrossbarGrid : public QGraphicsView, public Subscriber {
@@ -23,11 +29,15 @@ public:
 	CrossbarGrid(QWidget* parent, CrossbarModel* model);
 	
 	void notified();
+	void notified_changes(const ChangeSet& changes);
 	void notified_resize();
 	
 	void resize();
 	void setModel(CrossbarModel* model);
 
+protected:
+	void wheelEvent(QWheelEvent* event);
+	
 signals:
 	void notified_signal();
 	void notified_resize_signal();
@@ -45,6 +55,14 @@ private:
 	static const int X_PADDING = 15;
 	
 	static const int PEN_WIDTH = 3;
+	
+	// Largest side of the view (bigger crossbars are zoomed out to fit)
+	static const int MAX_VIEW_SIZE = 800;
+	
+	// Level of detail: below this many pixels per site the crossbar is
+	// drawn as an image of OVERVIEW_CELL pixels per site
+	static const int DETAIL_MIN_PIXELS = 16;
+	static const int OVERVIEW_CELL = 4;
 	static QPen GRAY_PEN;
 	static QPen RED_PEN;
 	static QPen BLUE_PEN;
@@ -54,6 +72,17 @@ private:
 	CrossbarModel* model;
 	QGraphicsScene* scene;
 	
+	// Items drawn when zoomed in (children of one layer, created the first
+	// time the crossbar is zoomed in) and the image drawn when zoomed out
+	QGraphicsRectItem* detail_layer;
+	OverviewItem* overview_item;
+	bool overview;
+	
+	// Changes not repainted yet (the player and the togglers notify them
+	// from the GUI thread; the lock keeps other threads safe too)
+	std::mutex changes_mutex;
+	ChangeSet pending_changes;
+	
 	// Dimensions
 	int m, n;
 	int height, width;
@@ -75,6 +104,19 @@ private:
 	std::map<int, QGraphicsLineItem*> draw_v_lines(int count);
 	std::map<int, TextValueChanger*> draw_d_lines(int count);
 	std::map<int, QubitCircle*> draw_qubits();
+	void draw_detail_items();
+	
+	// Level of detail
+	void update_level_of_detail();
+	void render_overview(const DirtyRegion& region);
+	
+	// Repaint methods (only the items of a change)
+	void repaint_detail_items();
+	void repaint_wave();
+	void repaint_h_line(int k);
+	void repaint_v_line(int k);
+	void repaint_d_line(int k);
+	void repaint_qubit(int q_id);
 	
 };
 
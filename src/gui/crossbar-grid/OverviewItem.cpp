@@ -0,0 +1,42 @@
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include "OverviewItem.h"
+
+/**
+ * Constructor
+ * @param width pixels of the image
+ * @param height
+ */
+OverviewItem::OverviewItem(int width, int height) : image(width, height, QImage::Format_RGB32) {
+	// The exposed rectangle limits the painting to the blocks updated
+	this->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+/**
+ * Image to draw into; call update_pixels with the pixels changed
+ */
+QImage& OverviewItem::get_image() {
+	return this->image;
+}
+
+/**
+ * Schedule the repaint of some pixels of the image
+ */
+void OverviewItem::update_pixels(int x, int y, int width, int height) {
+	this->update(QRectF(x, y, width, height));
+}
+
+QRectF OverviewItem::boundingRect() const {
+	return QRectF(0, 0, this->image.width(), this->image.height());
+}
+
+void OverviewItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) {
+	Q_UNUSED(widget);
+	
+	QRect exposed = option->exposedRect.toAlignedRect().intersected(this->image.rect());
+	if (exposed.isEmpty()) return;
+	
+	// One pixel of the image per block on the screen, without smoothing
+	painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+	painter->drawImage(exposed, this->image, exposed);
+}
@@ -0,0 +1,28 @@
+#ifndef CROSSBAR_SIMULATOR_OVERVIEWITEM_H
+#define CROSSBAR_SIMULATOR_OVERVIEWITEM_H
+
+#include <QImage>
+#include <QGraphicsItem>
+
+/**
+ * The crossbar zoomed out: an image with a block of pixels per site,
+ * painted as it is (without converting it to a pixmap) and repainted
+ * only in the blocks that changed
+ */
+class OverviewItem : public QGraphicsItem {
+	
+public:
+	// Constructor
+	OverviewItem(int width, int height);
+	
+	QImage& get_image();
+	void update_pixels(int x, int y, int width, int height);
+	
+	QRectF boundingRect() const;
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget);
+	
+private:
+	QImage image;
+};
+
+#endif /* CROSSBAR_SIMULATOR_OVERVIEWITEM_H */
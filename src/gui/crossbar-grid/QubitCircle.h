@@ -14,6 +14,7 @@ public:
 	// Constructor
 	QubitCircle(int q_id, bool is_ancillary) : QGraphicsEllipseItem(0, 0, QubitCircle::RADIUS, QubitCircle::RADIUS) {
 		QGraphicsTextItem* text = new QGraphicsTextItem(QString::number(q_id), this);
+		text->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
         if (q_id <= 9) {
             text->setPos(2, -3);
 		} else {
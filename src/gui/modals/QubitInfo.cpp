@@ -20,7 +20,7 @@ void QubitInfo::draw_dialog() {
 	this->ui->tableWidget->insertRow(0);
 	for (auto const &entry : this->model->iter_qubits_positions()) {
 		int q_id = entry.first;
-		QubitState* state = entry.second->get_state();
+		QubitState* state = this->model->get_qubit_state(q_id);
 		
 		std::stringstream labelStream;
 		labelStream << "Q " << q_id;
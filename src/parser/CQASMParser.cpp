@@ -53,6 +53,21 @@ int CQASMParser::get_num_qubits(std::string text) {
 	return num_qubits;
 }
 
+/**
+ * Replace the number of qubits declared in the cQASM text
+ * @param text
+ * @param num_qubits
+ * @return text with the new "qubits" statement
+ */
+std::string CQASMParser::set_num_qubits(std::string text, int num_qubits) {
+	std::regex exp("qubits(\\s|\\t|\\n|\\r)*[0-9]+");
+	return std::regex_replace(
+		text,
+		exp,
+		"qubits " + std::to_string(num_qubits)
+	);
+}
+
 /**
  * Translates from operations in "libqasm" to operations in the simulator.
  * @param operation
@@ -92,11 +107,13 @@ Operation* CQASMParser::translate_operation(compiler::Operation* operation, int
 	else if (gate_type == "z_shuttle_left"
 		|| gate_type == "s_shuttle_left" || gate_type == "t_shuttle_left"
 		|| gate_type == "sdag_shuttle_left" || gate_type == "tdag_shuttle_left") {
-		return new ShuttleGate(ShuttleGate::DIR_LEFT, qubit_indices.front(), line_number);
+		return new ShuttleGate(ShuttleGate::DIR_LEFT, qubit_indices.front(), line_number,
+			gate_type.substr(0, gate_type.find("_shuttle")));
 	} else if (gate_type == "z_shuttle_right"
 		|| gate_type == "s_shuttle_right" || gate_type == "t_shuttle_right"
 		|| gate_type == "sdag_shuttle_right" || gate_type == "tdag_shuttle_right") {
-		return new ShuttleGate(ShuttleGate::DIR_RIGHT, qubit_indices.front(), line_number);
+		return new ShuttleGate(ShuttleGate::DIR_RIGHT, qubit_indices.front(), line_number,
+			gate_type.substr(0, gate_type.find("_shuttle")));
 	}
 	
 	// One-qubit gate: method global
@@ -109,7 +126,8 @@ Operation* CQASMParser::translate_operation(compiler::Operation* operation, int
 			|| gate_type == "t" || gate_type == "tdag") {
 		
 		// TODO: add multiple direction
-		return new SingleGate(gate_type, SingleGate::DIR_LEFT, qubit_indices.front(), line_number);
+		return new SingleGate(gate_type, SingleGate::DIR_LEFT, qubit_indices.front(), line_number,
+			operation->getRotationAngle());
 	}
 	
 	// Two-qubit gate: sqrt(SWAP)
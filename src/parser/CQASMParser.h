@@ -1,6 +1,7 @@
 #ifndef CQASMPARSER_H
 #define CQASMPARSER_H
 
+#include <regex>
 #include <string>
 #include <iostream>
 #include <stdexcept>
@@ -20,6 +21,8 @@ public:
 	
 	static int get_num_qubits(std::string text);
 	
+	static std::string set_num_qubits(std::string text, int num_qubits);
+	
 private:
 	static Operation* translate_operation(compiler::Operation* operation, int line_number);
 };
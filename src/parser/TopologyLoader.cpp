@@ -0,0 +1,114 @@
+#include <memory>
+
+#include "TopologyLoader.h"
+
+/**
+ * Read and validate a topology file
+ * @param path
+ * @return the "topology" field of the file
+ */
+nlohmann::json TopologyLoader::read_file(std::string path) {
+	std::ifstream i(path);
+	if (!i) {
+		throw std::runtime_error("Unable to open file " + path);
+	}
+	
+	nlohmann::json config;
+	i >> config;
+	
+	TopologyLoader::validate(config);
+	
+	return config["topology"];
+}
+
+/**
+ * Check the fields of a topology file
+ * @param config
+ */
+void TopologyLoader::validate(const nlohmann::json& config) {
+	if (config.count("topology") <= 0) {
+		throw std::runtime_error("File does not have the topology field");
+	}
+	
+	if (config["topology"].count("init_configuration") <= 0) {
+		throw std::runtime_error("File does not have the init_configuration");
+	}
+	
+	if (config["topology"].count("x_size") <= 0 || config["topology"].count("y_size") <= 0) {
+		throw std::runtime_error("File does not have the size fields");
+	}
+}
+
+/**
+ * Create a crossbar with the size and qubits of the topology. The
+ * optional "timing" field sets the durations (in ns): {"cycle_time": 10,
+ * "durations": {"single_gate": 40, ...}, "latencies": {...}} with the
+ * names of TimingTable::get_kind. The optional "noise" field sets the
+ * decoherence (times in ns): {"relaxation_time": T1, "dephasing_time":
+ * default T_phi of the qubits, "shuttle_error": phase flip probability
+ * per step}; a qubit of "init_configuration" can set its own "dephasing_time".
+ * A "cycle_time" in "noise" is used if "timing" does not have one.
+ * @param topology
+ * @return new model
+ * @throws std::runtime_error if both fields set different cycle times
+ */
+CrossbarModel* TopologyLoader::load(const nlohmann::json& topology) {
+	int y_size = (int) topology["y_size"];
+	int x_size = (int) topology["x_size"];
+	// Deleted if any field is invalid
+	std::unique_ptr<CrossbarModel> model(new CrossbarModel(y_size, x_size,  0, 0));
+	
+	TimingTable timing;
+	if (topology.count("timing") > 0) {
+		const nlohmann::json& config = topology["timing"];
+		timing.set_cycle_time(config.value("cycle_time", timing.get_cycle_time()));
+		if (config.count("durations") > 0) {
+			for (nlohmann::json::const_iterator it = config["durations"].begin(); it != config["durations"].end(); ++it) {
+				timing.set_duration(TimingTable::get_kind(it.key()), (double) it.value());
+			}
+		}
+		if (config.count("latencies") > 0) {
+			for (nlohmann::json::const_iterator it = config["latencies"].begin(); it != config["latencies"].end(); ++it) {
+				timing.set_latency(TimingTable::get_kind(it.key()), (double) it.value());
+			}
+		}
+	}
+	if (topology.count("noise") > 0 && topology["noise"].count("cycle_time") > 0) {
+		double cycle_time = topology["noise"]["cycle_time"];
+		if (topology.count("timing") > 0 && topology["timing"].count("cycle_time") > 0
+				&& cycle_time != timing.get_cycle_time()) {
+			throw std::runtime_error("The noise and timing fields have different cycle times");
+		}
+		timing.set_cycle_time(cycle_time);
+	}
+	model->set_timing(timing);
+	
+	NoiseModel noise;
+	double dephasing_time = 0;
+	if (topology.count("noise") > 0) {
+		const nlohmann::json& config = topology["noise"];
+		noise.set_relaxation_time(config.value("relaxation_time", 0.0));
+		noise.set_shuttle_error(config.value("shuttle_error", 0.0));
+		dephasing_time = config.value("dephasing_time", 0.0);
+	}
+	model->set_noise_model(noise);
+	
+	for (nlohmann::json::const_iterator it = topology["init_configuration"].begin();
+			it != topology["init_configuration"].end(); ++it)
+	{
+		int q_id = std::stoi(it.key());
+		std::string type = it.value()["type"];
+		std::vector<int> value = it.value()["position"];
+		int i = value[0];
+		int j = value[1];
+		Qubit* qubit = new Qubit(
+			(j % 2 == 0) ? new QubitState(0, 1) : new QubitState(1, 0),
+			new QubitPosition(i, j),
+			(type.compare("ancilla") == 0)
+		);
+		qubit->set_dephasing_time(it.value().value("dephasing_time", dephasing_time));
+		model->add_qubit(q_id, qubit);
+	}
+	
+	return model.release();
+}
@@ -0,0 +1,20 @@
+#ifndef TOPOLOGYLOADER_H
+#define TOPOLOGYLOADER_H
+
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+#include "crossbar/CrossbarModel.h"
+
+class TopologyLoader {
+public:
+	static nlohmann::json read_file(std::string path);
+	
+	static void validate(const nlohmann::json& config);
+	
+	static CrossbarModel* load(const nlohmann::json& topology);
+};
+
+#endif /* TOPOLOGYLOADER_H */
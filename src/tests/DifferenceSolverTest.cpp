@@ -0,0 +1,101 @@
+#include <vector>
+
+#include "TestCheck.h"
+#include "crossbar/LineConstraint.h"
+#include "crossbar/CrossbarSolution.h"
+#include "crossbar/solvers/DifferenceSolver.h"
+
+/**
+ * Known answers of the difference solver: the lowest values that satisfy
+ * the constraints, and the instances it must hand to the CSP solver
+ */
+
+static const int M = 4;
+static const int N = 4;
+static const long MAX_D_VALUE = 10;
+
+static void test_known_solution() {
+	std::vector<LineConstraint> constraints = {
+		// RL 1 down, CL 2 equal to it
+		LineConstraint(LineConstraint::H_LINE, 1, LineConstraint::EQUAL, 1),
+		LineConstraint(LineConstraint::V_LINE, 2, LineConstraint::EQUAL, LineConstraint::H_LINE, 1),
+		// QL 0 > QL 1 > QL -1 > 2
+		LineConstraint(LineConstraint::D_LINE, 0, LineConstraint::GREATER, LineConstraint::D_LINE, 1),
+		LineConstraint(LineConstraint::D_LINE, 1, LineConstraint::GREATER, LineConstraint::D_LINE, -1),
+		LineConstraint(LineConstraint::D_LINE, -1, LineConstraint::GREATER, 2),
+		// QL 2 < QL 1 and equal to QL -2
+		LineConstraint(LineConstraint::D_LINE, 2, LineConstraint::LESS, LineConstraint::D_LINE, 1),
+		LineConstraint(LineConstraint::D_LINE, -2, LineConstraint::EQUAL, LineConstraint::D_LINE, 2),
+		LineConstraint(LineConstraint::D_LINE, -2, LineConstraint::GREATER, 0),
+		// Wave
+		LineConstraint(LineConstraint::WAVE, 0, LineConstraint::EQUAL, 2)
+	};
+	
+	DifferenceSolver solver(MAX_D_VALUE);
+	CrossbarSolution solution;
+	solution.reset(M, N);
+	CHECK(solver.solve(constraints, solution));
+	
+	CHECK(solution.get_h_line(1) == 1);
+	CHECK(solution.get_v_line(2) == 1);
+	CHECK(solution.get_d_line(-1) == 3);
+	CHECK(solution.get_d_line(1) == 4);
+	CHECK(solution.get_d_line(0) == 5);
+	CHECK(solution.get_d_line(2) == 1);
+	CHECK(solution.get_d_line(-2) == 1);
+	CHECK(solution.get_wave() == 2);
+	
+	// Solving again gives the same values
+	CrossbarSolution again;
+	again.reset(M, N);
+	CHECK(solver.solve(constraints, again));
+	CHECK(again == solution);
+}
+
+static void test_unsolvable() {
+	DifferenceSolver solver(MAX_D_VALUE);
+	CrossbarSolution solution;
+	solution.reset(M, N);
+	
+	// Two values for the same line
+	CHECK(!solver.solve({
+		LineConstraint(LineConstraint::H_LINE, 0, LineConstraint::EQUAL, 0),
+		LineConstraint(LineConstraint::H_LINE, 0, LineConstraint::EQUAL, 1)
+	}, solution));
+	
+	// Cycle of strict inequalities
+	CHECK(!solver.solve({
+		LineConstraint(LineConstraint::D_LINE, 0, LineConstraint::GREATER, LineConstraint::D_LINE, 1),
+		LineConstraint(LineConstraint::D_LINE, 1, LineConstraint::GREATER, LineConstraint::D_LINE, 2),
+		LineConstraint(LineConstraint::D_LINE, 2, LineConstraint::GREATER, LineConstraint::D_LINE, 0)
+	}, solution));
+	
+	// Strict inequality between lines forced to be equal
+	CHECK(!solver.solve({
+		LineConstraint(LineConstraint::D_LINE, 0, LineConstraint::EQUAL, LineConstraint::D_LINE, 1),
+		LineConstraint(LineConstraint::D_LINE, 1, LineConstraint::LESS, LineConstraint::D_LINE, 0)
+	}, solution));
+	
+	// Chain longer than the highest QL value
+	std::vector<LineConstraint> chain;
+	for (int k = -2; k < 2; k++) {
+		chain.push_back(LineConstraint(LineConstraint::D_LINE, k + 1, LineConstraint::GREATER, LineConstraint::D_LINE, k));
+	}
+	chain.push_back(LineConstraint(LineConstraint::D_LINE, -2, LineConstraint::GREATER, (int) MAX_D_VALUE - 4));
+	CHECK(!solver.solve(chain, solution));
+	
+	// One less fits exactly
+	chain.back() = LineConstraint(LineConstraint::D_LINE, -2, LineConstraint::GREATER, (int) MAX_D_VALUE - 5);
+	CHECK(solver.solve(chain, solution));
+	CHECK(solution.get_d_line(2) == MAX_D_VALUE);
+}
+
+int main() {
+	test_known_solution();
+	test_unsolvable();
+	
+	if (test_failures == 0) {
+		std::cout << "All difference solver checks passed" << std::endl;
+	}
+	return test_failures;
+}
@@ -0,0 +1,168 @@
+#include <complex>
+#include <vector>
+
+#include "TestCheck.h"
+#include "crossbar/CrossbarModel.h"
+#include "crossbar/ConstraintChecker.h"
+#include "crossbar/Timeline.h"
+#include "crossbar/operations/SingleGate.h"
+#include "crossbar/operations/Wait.h"
+
+/**
+ * Known answers of the history of the crossbar: undoing and redoing the
+ * cycles gives back the crossbar they started from
+ */
+
+static const double TOLERANCE = 1e-12;
+
+static void check_qubit_state(CrossbarModel& model, int q_id, std::complex<double> alpha, std::complex<double> beta) {
+	QubitState* state = model.get_qubit(q_id)->get_state();
+	CHECK_NEAR(std::abs(state->get_alpha() - alpha), 0, TOLERANCE);
+	CHECK_NEAR(std::abs(state->get_beta() - beta), 0, TOLERANCE);
+}
+
+/**
+ * Probabilities of the qubits after every cycle, executing them once
+ */
+static std::vector<std::vector<double> > execute(CrossbarModel* model, Timeline& timeline) {
+	std::vector<std::vector<double> > probabilities;
+	for (int curr_cycle = 0; curr_cycle <= timeline.get_num_cycles(); curr_cycle++) {
+		std::vector<double> cycle_probabilities;
+		for (int q_id = 0; q_id < 4; q_id++) {
+			cycle_probabilities.push_back(model->get_probability_one(q_id));
+		}
+		probabilities.push_back(cycle_probabilities);
+		
+		if (curr_cycle < timeline.get_num_cycles()) {
+			ConstraintChecker::step(model, timeline, curr_cycle);
+		}
+	}
+	return probabilities;
+}
+
+/**
+ * Go to a cycle like CrossbarSimulator does: back one cycle or to a
+ * snapshot from the history, then executing the cycles that can not be
+ * replayed
+ */
+static void go_to(CrossbarModel* model, Timeline& timeline, int& curr_cycle, int cycle) {
+	if (cycle == curr_cycle - 1 && model->step_back()) {
+		curr_cycle--;
+		return;
+	}
+	
+	model->seek(cycle);
+	curr_cycle = model->get_history_cycle();
+	while (curr_cycle < cycle) {
+		if (!model->step_forward()) {
+			ConstraintChecker::step(model, timeline, curr_cycle);
+		}
+		curr_cycle++;
+	}
+}
+
+static void check_probabilities(CrossbarModel* model, const std::vector<double>& expected) {
+	for (int q_id = 0; q_id < 4; q_id++) {
+		CHECK_NEAR(model->get_probability_one(q_id), expected[q_id], 1e-9);
+	}
+}
+
+static void test_seek_matches_execution(int checkpoint_interval, bool keep_states) {
+	// Gates on qubits 0 and 1, one every 5 cycles
+	std::vector<std::vector<Operation*> > operations;
+	const char* gates[] = {"h", "x", "t"};
+	for (int k = 0; k < 12; k++) {
+		operations.push_back({new SingleGate(gates[k % 3], 0, k % 2, k + 1)});
+		operations.push_back({new Wait(4)});
+	}
+	
+	CrossbarModel base(4, 4, 2, 2);
+	base.set_constraint_backend("difference");
+	base.start_simulation(1);
+	Timeline timeline(operations, base.get_timing());
+	int num_cycles = timeline.get_num_cycles();
+	
+	CrossbarModel* reference = base.clone();
+	std::vector<std::vector<double> > expected = execute(reference, timeline);
+	delete reference;
+	
+	CrossbarModel* model = base.clone();
+	model->start_history(checkpoint_interval, keep_states);
+	int curr_cycle = 0;
+	go_to(model, timeline, curr_cycle, num_cycles);
+	check_probabilities(model, expected[num_cycles]);
+	
+	// Back to the start one cycle at a time
+	while (curr_cycle > 0) {
+		go_to(model, timeline, curr_cycle, curr_cycle - 1);
+		check_probabilities(model, expected[curr_cycle]);
+	}
+	
+	// Jumps in both directions
+	int cycles[] = {13, 2, 30, 30, 17, num_cycles, 0, 9, 25};
+	for (int cycle : cycles) {
+		go_to(model, timeline, curr_cycle, cycle);
+		CHECK(curr_cycle == cycle);
+		check_probabilities(model, expected[cycle]);
+	}
+	
+	delete model;
+	for (const std::vector<Operation*>& p_operations : operations) {
+		delete p_operations.front();
+	}
+}
+
+static void test_measurement_undo() {
+	// Without simulation the measurement collapses the state of the qubit
+	CrossbarModel model(4, 4, 2, 2);
+	model.get_qubit(0)->get_state()->set_alpha(0.6);
+	model.get_qubit(0)->get_state()->set_beta(0.8);
+	model.set_seed(1);
+	model.start_history();
+	
+	int outcome = model.measure(0);
+	model.end_cycle();
+	std::complex<double> alpha = outcome ? 0 : 1;
+	std::complex<double> beta = outcome ? 1 : 0;
+	check_qubit_state(model, 0, alpha, beta);
+	CHECK(model.get_measurements().at(0) == outcome);
+	
+	// Undo: the qubit is in superposition and not measured again
+	CHECK(model.step_back());
+	check_qubit_state(model, 0, 0.6, 0.8);
+	CHECK(model.get_measurements().count(0) == 0);
+	
+	// Redo: the same outcome
+	CHECK(model.step_forward());
+	check_qubit_state(model, 0, alpha, beta);
+	CHECK(model.get_measurements().at(0) == outcome);
+	
+	// Seeking from the snapshot gives the same crossbar
+	model.seek(0);
+	check_qubit_state(model, 0, 0.6, 0.8);
+	model.seek(1);
+	check_qubit_state(model, 0, alpha, beta);
+	
+	// A new branch from cycle 0 forgets the old outcome
+	model.seek(0);
+	int basis = std::norm(model.get_qubit(1)->get_state()->get_beta()) > 0.5;
+	CHECK(model.measure(1) == basis);
+	model.end_cycle();
+	CHECK(model.get_history()->get_num_cycles() == 1);
+	CHECK(model.step_back());
+	check_qubit_state(model, 0, 0.6, 0.8);
+	CHECK(model.get_measurements().empty());
+}
+
+int main() {
+	test_measurement_undo();
+	
+	// Every version of the register kept, or only the snapshots
+	test_seek_matches_execution(1024, true);
+	test_seek_matches_execution(8, false);
+	
+	if (test_failures == 0) {
+		std::cout << "All history checks passed" << std::endl;
+	}
+	return test_failures;
+}
@@ -0,0 +1,114 @@
+#include <vector>
+
+#include "TestCheck.h"
+#include "crossbar/CrossbarModel.h"
+#include "crossbar/ConstraintChecker.h"
+#include "crossbar/Scheduler.h"
+#include "crossbar/Timeline.h"
+#include "crossbar/operations/Measurement.h"
+#include "crossbar/operations/Shuttling.h"
+#include "crossbar/operations/SingleGate.h"
+#include "crossbar/operations/Wait.h"
+
+/**
+ * Known answers of the scheduler on the 4x4 crossbar with 2 data and 2
+ * ancilla qubits: q0 at (0, 0), q1 at (0, 2), q2 at (1, 1), q3 at (1, 3)
+ */
+
+static std::vector<int> get_line_numbers(std::vector<std::vector<Operation*> >& operations) {
+	std::vector<int> line_numbers;
+	for (const std::vector<Operation*>& p_operations : operations) {
+		for (Operation* operation : p_operations) {
+			if (dynamic_cast<Wait*>(operation) == NULL) {
+				line_numbers.push_back(operation->get_line_number());
+			}
+		}
+	}
+	return line_numbers;
+}
+
+static const Timeline::Entry* find_entry(const Timeline& timeline, int line_number) {
+	for (const Timeline::Entry& entry : timeline.get_entries()) {
+		if (entry.value->get_line_number() == line_number) {
+			return &entry;
+		}
+	}
+	return NULL;
+}
+
+static void delete_operations(std::vector<std::vector<Operation*> >& operations) {
+	for (const std::vector<Operation*>& p_operations : operations) {
+		for (Operation* operation : p_operations) {
+			delete operation;
+		}
+	}
+}
+
+static void test_parallel_gates() {
+	CrossbarModel model(4, 4, 2, 2);
+	model.set_constraint_backend("difference");
+	
+	// Gates on different qubits, padded by hand
+	std::vector<std::vector<Operation*> > operations = {
+		{new SingleGate("x", 0, 0, 1)}, {new Wait(4)},
+		{new SingleGate("x", 0, 1, 2)}, {new Wait(4)},
+		{new SingleGate("x", 0, 2, 3)}, {new Wait(4)},
+		{new SingleGate("x", 0, 0, 4)}
+	};
+	ScheduleResult result = Scheduler::schedule(&model, operations);
+	CHECK(result.cycles_before == 20);
+	CHECK(result.cycles_after == 13);
+	CHECK(result.bundles_before == 4);
+	CHECK(result.bundles_after == 3);
+	
+	// The first two gates share a bundle, program order inside
+	CHECK(operations.front().size() == 2);
+	CHECK((get_line_numbers(operations) == std::vector<int>{1, 2, 3, 4}));
+	
+	CrossbarModel* checked = model.clone();
+	CHECK(ConstraintChecker::validate(checked, operations) == 0);
+	delete checked;
+	delete_operations(operations);
+}
+
+static void test_measurement_ancilla() {
+	CrossbarModel model(4, 4, 2, 2);
+	model.set_constraint_backend("difference");
+	
+	// q2 moves next to q1 and is the ancilla of its measurement, then
+	// moves back up: it must wait for the whole measurement
+	std::vector<std::vector<Operation*> > operations = {
+		{new Shuttling(Shuttling::DIR_DOWN, 2, 1)}, {new Wait(4)},
+		{new Measurement(Measurement::DIR_ANCILLA_LEFT, Measurement::DIR_SITE_UP, 1, 2)}, {new Wait(10)},
+		{new Shuttling(Shuttling::DIR_UP, 2, 3)}, {new Wait(4)},
+		{new SingleGate("x", 1, 0, 4)}
+	};
+	ScheduleResult result = Scheduler::schedule(&model, operations);
+	CHECK(result.cycles_before == 26);
+	CHECK(result.cycles_after == 20);
+	CHECK(result.bundles_after == 4);
+	CHECK((get_line_numbers(operations) == std::vector<int>{1, 2, 3, 4}));
+	
+	Timeline timeline(operations, model.get_timing());
+	const Timeline::Entry* measurement = find_entry(timeline, 2);
+	const Timeline::Entry* shuttling = find_entry(timeline, 3);
+	CHECK(measurement != NULL && shuttling != NULL);
+	if (measurement != NULL && shuttling != NULL) {
+		CHECK(shuttling->low > measurement->high);
+	}
+	
+	CrossbarModel* checked = model.clone();
+	CHECK(ConstraintChecker::validate(checked, operations) == 0);
+	delete checked;
+	delete_operations(operations);
+}
+
+int main() {
+	test_parallel_gates();
+	test_measurement_ancilla();
+	
+	if (test_failures == 0) {
+		std::cout << "All scheduler checks passed" << std::endl;
+	}
+	return test_failures;
+}
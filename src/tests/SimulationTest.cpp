@@ -0,0 +1,288 @@
+#include <cmath>
+#include <complex>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "crossbar/simulation/GateMatrix.h"
+#include "crossbar/simulation/StateVector.h"
+#include "crossbar/simulation/StabilizerTableau.h"
+#include "crossbar/simulation/QuantumBackend.h"
+#include "crossbar/simulation/ShotSampler.h"
+
+/**
+ * Known answers of the quantum state simulation: the kernels of the state
+ * vector, Bell and GHZ states on both backends, the stabilizer tableau
+ * against the state vector on a Clifford circuit and the shots sampled
+ * from the affine analysis of a stabilizer state
+ */
+
+static const double TOLERANCE = 1e-12;
+
+static void cnot(StateVector& state, int control, int target) {
+	GateMatrix h = GateMatrix::from_name("h");
+	state.apply(h, target);
+	state.apply_controlled_phase(control, target, -1);
+	state.apply(h, target);
+}
+
+static void test_state_vector_kernels() {
+	// H|0> = (|0> + |1>) / sqrt(2)
+	StateVector state(1);
+	state.apply(GateMatrix::from_name("h"), 0);
+	CHECK_NEAR(state.get_amplitude(0).real(), 1 / std::sqrt(2), TOLERANCE);
+	CHECK_NEAR(state.get_amplitude(1).real(), 1 / std::sqrt(2), TOLERANCE);
+	CHECK_NEAR(state.get_probability_one(0), 0.5, TOLERANCE);
+	
+	// X on the second qubit of |00> gives |10> (qubit k is bit k of the index)
+	StateVector pair(2);
+	pair.apply(GateMatrix::from_name("x"), 1);
+	CHECK_NEAR(std::norm(pair.get_amplitude(2)), 1, TOLERANCE);
+	CHECK_NEAR(pair.get_probability_one(0), 0, TOLERANCE);
+	CHECK_NEAR(pair.get_probability_one(1), 1, TOLERANCE);
+	
+	// The controlled phase only changes |11>
+	StateVector phase(2);
+	phase.apply(GateMatrix::from_name("h"), 0);
+	phase.apply(GateMatrix::from_name("h"), 1);
+	phase.apply_controlled_phase(0, 1, std::complex<double>(0, 1));
+	CHECK_NEAR(phase.get_amplitude(0).real(), 0.5, TOLERANCE);
+	CHECK_NEAR(phase.get_amplitude(1).real(), 0.5, TOLERANCE);
+	CHECK_NEAR(phase.get_amplitude(2).real(), 0.5, TOLERANCE);
+	CHECK_NEAR(phase.get_amplitude(3).real(), 0, TOLERANCE);
+	CHECK_NEAR(phase.get_amplitude(3).imag(), 0.5, TOLERANCE);
+	
+	// sqrt(SWAP)|01> = (1 + i) / 2 |01> + (1 - i) / 2 |10>, twice is SWAP
+	StateVector swap(2);
+	swap.apply(GateMatrix::from_name("x"), 0);
+	swap.apply_sqswap(0, 1);
+	CHECK_NEAR(swap.get_amplitude(1).real(), 0.5, TOLERANCE);
+	CHECK_NEAR(swap.get_amplitude(1).imag(), 0.5, TOLERANCE);
+	CHECK_NEAR(swap.get_amplitude(2).real(), 0.5, TOLERANCE);
+	CHECK_NEAR(swap.get_amplitude(2).imag(), -0.5, TOLERANCE);
+	swap.apply_sqswap(0, 1);
+	CHECK_NEAR(std::norm(swap.get_amplitude(2)), 1, TOLERANCE);
+	
+	// Measuring collapses: an outcome 1 leaves |1>
+	StateVector collapse(1);
+	collapse.apply(GateMatrix::from_name("h"), 0);
+	CHECK(collapse.measure(0, 0.75) == 1);
+	CHECK_NEAR(collapse.get_probability_one(0), 1, TOLERANCE);
+	CHECK_NEAR(std::norm(collapse.get_amplitude(1)), 1, TOLERANCE);
+	
+	// Large registers give the same amplitudes with any number of threads
+	int num_qubits = 17;
+	StateVector serial(num_qubits);
+	StateVector parallel(num_qubits);
+	serial.set_num_threads(1);
+	parallel.set_num_threads(4);
+	for (StateVector* register_state : {&serial, &parallel}) {
+		for (int q = 0; q < num_qubits; q++) {
+			register_state->apply(GateMatrix::from_name("ry", 0.1 * (q + 1)), q);
+		}
+		for (int q = 0; q + 1 < num_qubits; q++) {
+			register_state->apply_controlled_phase(q, q + 1, std::complex<double>(0, 1));
+		}
+		register_state->apply_sqswap(3, 12);
+	}
+	bool same = true;
+	for (size_t index = 0; index < serial.get_size(); index++) {
+		same = same && serial.get_amplitude(index) == parallel.get_amplitude(index);
+	}
+	CHECK(same);
+	for (int q = 0; q < num_qubits; q++) {
+		CHECK(serial.get_probability_one(q) == parallel.get_probability_one(q));
+	}
+}
+
+static void test_bell_and_ghz() {
+	// Bell: the qubits are random but always equal
+	for (double random : {0.25, 0.75}) {
+		StateVector bell(2);
+		bell.apply(GateMatrix::from_name("h"), 0);
+		cnot(bell, 0, 1);
+		CHECK_NEAR(std::norm(bell.get_amplitude(0)), 0.5, TOLERANCE);
+		CHECK_NEAR(std::norm(bell.get_amplitude(3)), 0.5, TOLERANCE);
+		CHECK_NEAR(bell.get_probability_one(1), 0.5, TOLERANCE);
+		
+		int outcome = bell.measure(0, random);
+		CHECK(outcome == (random < 0.5 ? 0 : 1));
+		CHECK_NEAR(bell.get_probability_one(1), outcome, TOLERANCE);
+		
+		StabilizerTableau tableau(2);
+		tableau.h(0);
+		tableau.cnot(0, 1);
+		CHECK(!tableau.is_deterministic(0));
+		CHECK(!tableau.is_deterministic(1));
+		CHECK(tableau.measure(0, random) == outcome);
+		CHECK(tableau.is_deterministic(1));
+		CHECK(tableau.get_deterministic_outcome(1) == outcome);
+	}
+	
+	// GHZ of 5 qubits: after the first outcome the others are fixed
+	int num_qubits = 5;
+	StateVector ghz(num_qubits);
+	StabilizerTableau tableau(num_qubits);
+	ghz.apply(GateMatrix::from_name("h"), 0);
+	tableau.h(0);
+	for (int q = 1; q < num_qubits; q++) {
+		cnot(ghz, q - 1, q);
+		tableau.cnot(q - 1, q);
+	}
+	CHECK_NEAR(std::norm(ghz.get_amplitude(0)), 0.5, TOLERANCE);
+	CHECK_NEAR(std::norm(ghz.get_amplitude(ghz.get_size() - 1)), 0.5, TOLERANCE);
+	
+	CHECK(ghz.measure(2, 0.9) == 1);
+	CHECK(tableau.measure(2, 0.9) == 1);
+	for (int q = 0; q < num_qubits; q++) {
+		CHECK_NEAR(ghz.get_probability_one(q), 1, TOLERANCE);
+		CHECK(tableau.is_deterministic(q));
+		CHECK(tableau.get_deterministic_outcome(q) == 1);
+	}
+}
+
+static void test_stabilizer_tableau() {
+	// Paulis only change the sign of the stabilizers
+	StabilizerTableau paulis(3);
+	paulis.x(0);
+	paulis.y(1);
+	paulis.z(2);
+	CHECK(paulis.get_deterministic_outcome(0) == 1);
+	CHECK(paulis.get_deterministic_outcome(1) == 1);
+	CHECK(paulis.get_deterministic_outcome(2) == 0);
+	
+	// HSSH = X and HSH applied twice is X too
+	StabilizerTableau phases(1);
+	phases.h(0);
+	phases.s(0);
+	phases.s(0);
+	phases.h(0);
+	CHECK(phases.get_deterministic_outcome(0) == 1);
+	
+	// The outcome of Z1 Z2 after measuring Z1 comes from multiplying the
+	// rows of the stabilizers: |000> + |111> measured on qubit 0 as 0
+	StabilizerTableau rows(3);
+	rows.h(0);
+	rows.cnot(0, 1);
+	rows.cnot(0, 2);
+	rows.x(1);
+	CHECK(rows.measure(0, 0.1) == 0);
+	CHECK(rows.get_deterministic_outcome(1) == 1);
+	CHECK(rows.get_deterministic_outcome(2) == 0);
+	
+	// Measuring again gives the same outcome whatever the random number
+	CHECK(rows.measure(0, 0.9) == 0);
+	CHECK(rows.measure(1, 0.1) == 1);
+	
+	// Beyond 64 qubits the rows take several words
+	StabilizerTableau wide(130);
+	wide.h(0);
+	wide.cnot(0, 65);
+	wide.cnot(65, 129);
+	CHECK(wide.measure(129, 0.8) == 1);
+	CHECK(wide.get_deterministic_outcome(0) == 1);
+	CHECK(wide.get_deterministic_outcome(65) == 1);
+	CHECK(wide.get_deterministic_outcome(64) == 0);
+}
+
+static void test_backends_agree() {
+	// Same Clifford circuit on both backends
+	int num_qubits = 5;
+	QuantumBackend* backends[] = {
+		QuantumBackend::create("statevector", num_qubits, 1),
+		QuantumBackend::create("stabilizer", num_qubits)
+	};
+	for (QuantumBackend* backend : backends) {
+		backend->apply_gate("h", 0);
+		backend->apply_gate("s", 0);
+		backend->apply_gate("h", 1);
+		backend->apply_cz(0, 1);
+		backend->apply_gate("x", 2);
+		backend->apply_gate("h", 3);
+		backend->apply_cz(3, 2);
+		backend->apply_gate("y", 1);
+		backend->apply_gate("h", 2);
+		backend->apply_gate("sdag", 3);
+		backend->apply_cz(1, 2);
+		backend->apply_gate("h", 0);
+		backend->apply_gate("z", 4);
+		backend->apply_gate("h", 4);
+		backend->apply_cz(4, 0);
+		backend->apply_gate("h", 4);
+		backend->flush();
+	}
+	for (int q = 0; q < num_qubits; q++) {
+		CHECK_NEAR(backends[0]->get_probability_one(q), backends[1]->get_probability_one(q), 1e-9);
+	}
+	
+	// The probabilities are 0, 1/2 or 1, so the same random numbers give
+	// the same outcomes
+	double randoms[] = {0.3, 0.8, 0.1, 0.6, 0.4};
+	for (int q = 0; q < num_qubits; q++) {
+		int outcome = backends[0]->measure(q, randoms[q]);
+		CHECK(backends[1]->measure(q, randoms[q]) == outcome);
+		for (int other = 0; other < num_qubits; other++) {
+			CHECK_NEAR(backends[0]->get_probability_one(other), backends[1]->get_probability_one(other), 1e-9);
+		}
+	}
+	
+	for (QuantumBackend* backend : backends) {
+		delete backend;
+	}
+}
+
+static void test_shot_sampler() {
+	// GHZ on the first 3 qubits, qubit 3 flipped: the random outcomes are
+	// the same bit on the GHZ qubits and qubit 3 is always 1
+	int num_qubits = 4;
+	QuantumBackend* stabilizer = QuantumBackend::create("stabilizer", num_qubits);
+	QuantumBackend* statevector = QuantumBackend::create("statevector", num_qubits, 1);
+	for (QuantumBackend* backend : {stabilizer, statevector}) {
+		backend->apply_gate("h", 0);
+		backend->apply_gate("h", 1);
+		backend->apply_cz(0, 1);
+		backend->apply_gate("h", 1);
+		backend->apply_gate("h", 2);
+		backend->apply_cz(1, 2);
+		backend->apply_gate("h", 2);
+		backend->apply_gate("x", 3);
+		backend->flush();
+	}
+	
+	std::vector<int> qubits = {3, 0, 1, 2};
+	int shots = 10000;
+	for (QuantumBackend* backend : {stabilizer, statevector}) {
+		ShotSampler sampler(backend, qubits);
+		std::map<std::string, int> counts = sampler.sample(shots, 42, 1);
+		CHECK(counts.size() == 2);
+		CHECK_NEAR(counts["1000"] + counts["1111"], shots, 0);
+		CHECK_NEAR(counts["1000"], shots / 2, 300);
+		
+		// Same seed, same counts with any number of threads
+		CHECK(sampler.sample(shots, 42, 3) == counts);
+		CHECK(sampler.sample(shots, 43, 1) != counts);
+	}
+	
+	// Noise flips the outcome of the first qubit of shot 0
+	ShotSampler sampler(stabilizer, {3});
+	std::vector<std::vector<uint64_t> > flips = {{1}};
+	std::map<std::string, int> counts = sampler.sample(10, 7, 1, &flips);
+	CHECK(counts["0"] == 1);
+	CHECK(counts["1"] == 9);
+	
+	delete stabilizer;
+	delete statevector;
+}
+
+int main() {
+	test_state_vector_kernels();
+	test_bell_and_ghz();
+	test_stabilizer_tableau();
+	test_backends_agree();
+	test_shot_sampler();
+	
+	if (test_failures == 0) {
+		std::cout << "All simulation checks passed" << std::endl;
+	}
+	return test_failures;
+}
@@ -0,0 +1,32 @@
+#ifndef CROSSBAR_SIMULATOR_TESTCHECK_H
+#define CROSSBAR_SIMULATOR_TESTCHECK_H
+
+#include <cmath>
+#include <iostream>
+
+/**
+ * Minimal checks for the known-answer tests: a failed check is reported
+ * with its line and the test goes on; main returns the number of failures
+ */
+static int test_failures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+			test_failures++; \
+		} \
+	} while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+	do { \
+		double test_actual = (actual); \
+		double test_expected = (expected); \
+		if (!(std::abs(test_actual - test_expected) <= (tolerance))) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": " #actual " is " << test_actual \
+				<< ", expected " << test_expected << std::endl; \
+			test_failures++; \
+		} \
+	} while (0)
+
+#endif /* CROSSBAR_SIMULATOR_TESTCHECK_H */
@@ -0,0 +1,118 @@
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "crossbar/CrossbarModel.h"
+#include "crossbar/ConstraintChecker.h"
+#include "crossbar/Timeline.h"
+#include "crossbar/operations/SingleGate.h"
+#include "crossbar/operations/Wait.h"
+
+/**
+ * Known answers of the timeline: the operations active in each cycle and
+ * the idle cycles jumped over by the validation
+ */
+
+static std::vector<int> get_active_lines(Timeline& timeline, int cycle) {
+	std::vector<int> line_numbers;
+	for (const Timeline::Entry& entry : timeline.get_active(cycle)) {
+		line_numbers.push_back(entry.value->get_line_number());
+	}
+	return line_numbers;
+}
+
+static void delete_operations(std::vector<std::vector<Operation*> >& operations) {
+	for (const std::vector<Operation*>& p_operations : operations) {
+		for (Operation* operation : p_operations) {
+			delete operation;
+		}
+	}
+}
+
+static void test_active() {
+	// Gates take 5 cycles: [0, 4], [7, 11], [8, 12] and [29, 33]
+	std::vector<std::vector<Operation*> > operations = {
+		{new SingleGate("x", 0, 0, 1), new SingleGate("x", 0, 1, 2)}, {new Wait(6)},
+		{new SingleGate("x", 0, 2, 3)},
+		{new SingleGate("x", 0, 0, 4)}, {new Wait(20)},
+		{new SingleGate("x", 0, 1, 5)}
+	};
+	Timeline timeline(operations);
+	CHECK(timeline.get_num_cycles() == 34);
+	
+	CHECK((get_active_lines(timeline, 0) == std::vector<int>{1, 2}));
+	CHECK((get_active_lines(timeline, 4) == std::vector<int>{1, 2}));
+	CHECK(get_active_lines(timeline, 5).empty());
+	CHECK((get_active_lines(timeline, 7) == std::vector<int>{3}));
+	CHECK((get_active_lines(timeline, 8) == std::vector<int>{3, 4}));
+	CHECK((get_active_lines(timeline, 11) == std::vector<int>{3, 4}));
+	CHECK((get_active_lines(timeline, 12) == std::vector<int>{4}));
+	CHECK(get_active_lines(timeline, 13).empty());
+	CHECK((get_active_lines(timeline, 29) == std::vector<int>{5}));
+	
+	// Going back starts over
+	CHECK((get_active_lines(timeline, 8) == std::vector<int>{3, 4}));
+	
+	CHECK(timeline.get_next_start(5) == 7);
+	CHECK(timeline.get_next_start(13) == 29);
+	CHECK(timeline.get_next_start(30) == 34);
+	
+	// An operation added later goes after the ones starting with it
+	Operation* added = new SingleGate("x", 0, 3, 7);
+	timeline.add_operation(0, added);
+	CHECK((get_active_lines(timeline, 0) == std::vector<int>{1, 2, 7}));
+	
+	delete added;
+	delete_operations(operations);
+}
+
+static void test_idle_skipping() {
+	// The second gate starts at cycle 21: cycles 5-20 are idle
+	std::vector<std::vector<Operation*> > operations = {
+		{new SingleGate("x", 0, 0, 1)}, {new Wait(20)},
+		{new SingleGate("x", 0, 1, 3)}
+	};
+	
+	CrossbarModel model(4, 4, 2, 2);
+	model.set_constraint_backend("difference");
+	NoiseModel noise;
+	noise.set_relaxation_time(1000);
+	model.set_noise_model(noise);
+	
+	// Every cycle validated on its own
+	CrossbarModel* expected = model.clone();
+	Timeline timeline(operations, model.get_timing());
+	for (int curr_cycle = 0; curr_cycle < timeline.get_num_cycles(); curr_cycle++) {
+		ConstraintChecker::validate_cycle(expected, timeline.get_active(curr_cycle), curr_cycle, NULL);
+	}
+	
+	std::ostringstream report;
+	CHECK(ConstraintChecker::validate(&model, operations, &report) == 0);
+	CHECK(report.str().find("cycles 6-20: idle") != std::string::npos);
+	
+	// Jumping over the idle cycles ends the same
+	CHECK(model.has_same_configuration(expected));
+	const std::map<int, double>& errors = model.get_errors();
+	const std::map<int, double>& expected_errors = expected->get_errors();
+	CHECK(errors.size() == expected_errors.size());
+	for (const auto& error : expected_errors) {
+		CHECK(errors.count(error.first) == 1);
+		CHECK_NEAR(errors.at(error.first), error.second, 1e-12);
+	}
+	CHECK(!expected_errors.empty());
+	
+	delete expected;
+	delete_operations(operations);
+}
+
+int main() {
+	test_active();
+	test_idle_skipping();
+	
+	if (test_failures == 0) {
+		std::cout << "All timeline checks passed" << std::endl;
+	}
+	return test_failures;
+}